@@ -7,6 +7,7 @@
 #include <parlay/monoid.h>
 #include <parlay/primitives.h>
 #include <parlay/random.h>
+#include <parlay/sorted_index.h>
 
 using benchmark::Counter;
 
@@ -59,6 +60,19 @@ static void bench_map(benchmark::State& state) {
   REPORT_STATS(n, 2*sizeof(T), sizeof(T));
 }
 
+template<typename T>
+static void bench_copy(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto In = parlay::sequence<T>(n, 1);
+  auto Out = parlay::sequence<T>(n, 0);
+
+  for (auto _ : state) {
+    parlay::copy(In, Out);
+  }
+
+  REPORT_STATS(n, sizeof(T), sizeof(T));
+}
+
 template<typename T>
 static void bench_tabulate(benchmark::State& state) {
   size_t n = state.range(0);
@@ -108,6 +122,47 @@ static void bench_pack(benchmark::State& state) {
   REPORT_STATS(n, 14, 4);  // Why 14 and 4?
 }
 
+template<typename T>
+static void bench_pack_random(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto flags = parlay::tabulate(n, [] (size_t i) -> bool {return parlay::hash64(i) % 2;});
+  auto In = parlay::tabulate(n, [] (size_t i) -> T {return i;});
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::pack(In, flags));
+  }
+
+  REPORT_STATS(n, 1 + 3*sizeof(T)/2, sizeof(T)/2);
+}
+
+template<typename T>
+static void bench_pack_index(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto flags = parlay::tabulate(n, [] (size_t i) -> bool {return parlay::hash64(i) % 2;});
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::pack_index<T>(flags));
+  }
+
+  REPORT_STATS(n, 1 + sizeof(T)/2, sizeof(T)/2);
+}
+
+template<typename T>
+static void bench_partition(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto In = parlay::tabulate(n, [] (size_t i) -> T {return parlay::hash64(i);});
+  auto f = [] (T x) { return (x & 1) == 0; };
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto A = In;
+    state.ResumeTiming();
+    parlay::partition(A, f);
+  }
+
+  REPORT_STATS(n, 3*sizeof(T), sizeof(T));
+}
+
 template<typename T>
 static void bench_gather(benchmark::State& state) {
   size_t n = state.range(0);
@@ -237,6 +292,67 @@ static void bench_random_shuffle(benchmark::State& state) {
   REPORT_STATS(n, 0, 0);
 }
 
+// random_shuffle as it was before the generator was Philox, where the
+// i'th random number of the generator with state s was hash64(i + s)
+template<typename T>
+static parlay::sequence<T> random_shuffle_hash64(const parlay::sequence<T>& In, size_t seed) {
+  auto rand = [](size_t s, size_t i) -> size_t { return parlay::hash64(i + s); };
+  auto knuth = [&](auto A, size_t s) {
+    for (size_t i = A.size(); i-- > 1;) std::swap(A[i], A[rand(s, i) % (i + 1)]);
+  };
+  size_t n = In.size();
+  auto Out = parlay::sequence<T>::uninitialized(n);
+  size_t bits = (n < (1 << 27)) ? (parlay::log2_up(n) - 7) / 2 : parlay::log2_up(n) - 17;
+  size_t num_buckets = size_t{1} << bits;
+  auto get_pos = parlay::delayed_seq<size_t>(n, [&](size_t i) { return rand(seed, i) & (num_buckets - 1); });
+  auto [offsets, single] = parlay::internal::count_sort<parlay::uninitialized_copy_tag>(
+      parlay::make_slice(In), parlay::make_slice(Out), parlay::make_slice(get_pos), num_buckets);
+  parlay::parallel_for(0, num_buckets, [&](size_t i) {
+    size_t s = parlay::hash64(parlay::hash64(i + seed));
+    knuth(parlay::make_slice(Out).cut(offsets[i], offsets[i + 1]), s);
+  }, 1);
+  return Out;
+}
+
+template<typename T>
+static void bench_random_shuffle_hash64(benchmark::State& state) {
+  size_t n = state.range(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T {return i;});
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(random_shuffle_hash64(in, n));
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
+template<typename T>
+static void bench_random_sequence(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto dist = parlay::uniform_real_distribution<T>();
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::random_sequence(n, dist, r));
+  }
+
+  REPORT_STATS(n, 0, sizeof(T));
+}
+
+template<typename T>
+static void bench_weighted_random_sample(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T {return i;});
+  auto weights = parlay::tabulate(n, [&] (size_t i) -> double {return r.ith_rand(i) % 1000;});
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::weighted_random_sample(in, weights, n, r));
+  }
+
+  REPORT_STATS(n, 2*sizeof(T), sizeof(T));
+}
+
 template<typename T>
 static void bench_histogram(benchmark::State& state) {
   size_t n = state.range(0);
@@ -312,6 +428,25 @@ static void bench_integer_sort(benchmark::State& state) {
   REPORT_STATS(n, 0, 0);
 }
 
+template<typename T>
+static void bench_integer_sort_inplace_low_memory(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  size_t bits = sizeof(T)*8;
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T {return r.ith_rand(i);});
+  auto out = in;
+  auto identity = [] (T a) {return a;};
+
+  while (state.KeepRunningBatch(10)) {
+    for (int i = 0; i < 10; i++) {
+      COPY_NO_TIME(out, in);
+      parlay::internal::integer_sort_inplace(parlay::make_slice(out), identity, bits, parlay::fl_low_memory);
+    }
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
 template<typename T>
 static void bench_integer_sort_128(benchmark::State& state) {
   size_t n = state.range(0);
@@ -345,6 +480,23 @@ static void bench_sort(benchmark::State& state) {
   REPORT_STATS(n, 0, 0);
 }
 
+// Sorting floating-point numbers, which parlay::sort dispatches to the
+// integer sort
+template<typename T>
+static void bench_sort_floating(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T {return static_cast<T>(r.ith_rand(i)) / 3 - n;});
+
+  while (state.KeepRunningBatch(10)) {
+    for (int i = 0; i < 10; i++) {
+      RUN_AND_CLEAR(parlay::sort(in));
+    }
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
 template<typename T>
 static void bench_sort_inplace(benchmark::State& state) {
   size_t n = state.range(0);
@@ -362,6 +514,25 @@ static void bench_sort_inplace(benchmark::State& state) {
   REPORT_STATS(n, 0, 0);
 }
 
+// The in-place sample sort that distributes through a buffer of size n,
+// for comparison with the in-place super scalar sample sort
+template<typename T>
+static void bench_sort_inplace_transpose(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T {return r.ith_rand(i)%n;});
+  auto out = in;
+
+  while (state.KeepRunningBatch(10)) {
+    for (int i = 0; i < 10; i++) {
+      COPY_NO_TIME(out, in);
+      parlay::internal::sample_sort_inplace_<size_t>(parlay::make_slice(out), parlay::make_slice(out), std::less<T>());
+    }
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
 template<typename T>
 static void bench_merge(benchmark::State& state) {
   size_t n = state.range(0);
@@ -441,6 +612,64 @@ static void bench_collect_reduce(benchmark::State& state) {
   REPORT_STATS(n, 0, 0);
 }
 
+template<typename T>
+static void bench_remove_duplicates(benchmark::State& state) {
+  size_t n = state.range(0);
+  size_t distinct = state.range(1);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % distinct; });
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::remove_duplicates(in));
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
+template<typename T>
+static void bench_remove_duplicates_ordered(benchmark::State& state) {
+  size_t n = state.range(0);
+  size_t distinct = state.range(1);
+  parlay::random r(0);
+  auto in = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % distinct; });
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::remove_duplicates_ordered(in, std::less<T>()));
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
+template<typename T>
+static void bench_lower_bound_std(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto keys = parlay::tabulate(n, [&] (size_t i) -> T { return 2 * i; });
+  auto queries = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % (2 * n); });
+  auto f = [&] (T x) -> size_t { return std::lower_bound(keys.begin(), keys.end(), x) - keys.begin(); };
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(parlay::map(queries, f));
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
+template<typename T>
+static void bench_lower_bound_sorted_index(benchmark::State& state) {
+  size_t n = state.range(0);
+  parlay::random r(0);
+  auto keys = parlay::tabulate(n, [&] (size_t i) -> T { return 2 * i; });
+  auto queries = parlay::tabulate(n, [&] (size_t i) -> T { return r.ith_rand(i) % (2 * n); });
+  auto index = parlay::sorted_index<T>(keys);
+
+  for (auto _ : state) {
+    RUN_AND_CLEAR(index.lower_bound(queries));
+  }
+
+  REPORT_STATS(n, 0, 0);
+}
+
 // ------------------------- Registration -------------------------------
 
 #define BENCH(NAME, T, args...) BENCHMARK_TEMPLATE(bench_ ## NAME, T)               \
@@ -450,27 +679,44 @@ static void bench_collect_reduce(benchmark::State& state) {
 
 BENCH(map, long, 100000000);
 BENCH(tabulate, long, 100000000);
+BENCH(copy, long, 100000000);
 BENCH(reduce_add, long, 100000000);
+BENCH(reduce_add, int, 100000000);
+BENCH(reduce_add, double, 100000000);
 BENCH(scan_add, long, 100000000);
+BENCH(scan_add, int, 100000000);
+BENCH(scan_add, double, 100000000);
 BENCH(pack, long, 100000000);
+BENCH(pack_random, long, 100000000);
+BENCH(pack_random, int, 100000000);
+BENCH(pack_index, unsigned int, 100000000);
+BENCH(partition, long, 100000000);
 BENCH(gather, long, 100000000);
 BENCH(scatter, long, 100000000);
 BENCH(write_add, long, 100000000);
 BENCH(write_min, long, 100000000);
 BENCH(count_sort, long, 100000000, 8);
 BENCH(random_shuffle, long, 100000000);
+BENCH(random_shuffle_hash64, long, 100000000);
+BENCH(random_sequence, double, 100000000);
+BENCH(weighted_random_sample, long, 100000000);
 BENCH(histogram, unsigned int, 100000000);
 BENCH(histogram_same, unsigned int, 100000000);
 BENCH(histogram_few, unsigned int, 100000000);
 BENCH(integer_sort, unsigned int, 100000000);
+BENCH(integer_sort_inplace_low_memory, unsigned int, 100000000);
 BENCH(integer_sort_pair, unsigned int, 100000000);
 BENCH(integer_sort_128, __int128, 100000000);
 BENCH(sort, unsigned int, 100000000);
 BENCH(sort, long, 100000000);
 BENCH(sort, __int128, 100000000);
+BENCH(sort_floating, float, 100000000);
+BENCH(sort_floating, double, 100000000);
 BENCH(sort_inplace, unsigned int, 100000000);
 BENCH(sort_inplace, long, 100000000);
 BENCH(sort_inplace, __int128, 100000000);
+BENCH(sort_inplace_transpose, unsigned int, 100000000);
+BENCH(sort_inplace_transpose, long, 100000000);
 BENCH(merge, long, 100000000);
 BENCH(scatter, int, 100000000);
 BENCH(merge_sort, long, 100000000);
@@ -478,3 +724,11 @@ BENCH(count_sort, long, 100000000, 2);
 BENCH(split3, long, 100000000);
 BENCH(quicksort, long, 100000000);
 BENCH(collect_reduce, unsigned int, 100000000);
+BENCH(remove_duplicates, long, 100000000, 1000);
+BENCH(remove_duplicates, long, 100000000, 1000000);
+BENCH(remove_duplicates, long, 100000000, 100000000);
+BENCH(remove_duplicates_ordered, long, 100000000, 1000);
+BENCH(remove_duplicates_ordered, long, 100000000, 1000000);
+BENCH(remove_duplicates_ordered, long, 100000000, 100000000);
+BENCH(lower_bound_std, long, 100000000);
+BENCH(lower_bound_sorted_index, long, 100000000);
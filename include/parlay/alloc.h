@@ -295,6 +295,58 @@ extern inline void p_free(void* ptr) {
 }
 #endif
 
+// ****************************************
+// An allocator whose buffers are aligned to the given alignment (a power
+// of two, by default the size of a cache line). When used with a sequence,
+// the sequence also aligns its elements to this boundary, so that data()
+// is aligned, e.g.
+//    parlay::sequence<float, parlay::aligned_allocator<float>> s(n);
+//    assert(reinterpret_cast<uintptr_t>(s.data()) % 64 == 0);
+// ****************************************
+
+template <typename T, size_t Alignment = 64>
+struct aligned_allocator {
+  static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+  static_assert(Alignment >= alignof(T), "alignment must be at least the alignment of the value type");
+
+  using value_type = T;
+  static constexpr size_t alignment = Alignment;
+
+  template <class U>
+  struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+  // The pool hands out power-of-two sized blocks aligned to their size (up
+  // to 256 bytes) or to 64 bytes for large blocks, so rounding small requests
+  // up to the alignment is enough for alignments of up to 64 bytes.
+  T* allocate(size_t n) {
+    size_t bytes = n * sizeof(T);
+#ifndef PARLAY_USE_STD_ALLOC
+    if constexpr (Alignment <= 64) {
+      return (T*) internal::get_default_allocator().allocate((std::max)(bytes, Alignment));
+    }
+#endif
+    return (T*) ::operator new(bytes, std::align_val_t{Alignment});
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    size_t bytes = n * sizeof(T);
+#ifndef PARLAY_USE_STD_ALLOC
+    if constexpr (Alignment <= 64) {
+      return internal::get_default_allocator().deallocate((void*) ptr, (std::max)(bytes, Alignment));
+    }
+#endif
+    ::operator delete((void*) ptr, std::align_val_t{Alignment});
+  }
+
+  constexpr aligned_allocator() = default;
+  template <class U> constexpr aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept { }
+};
+
+template <class T, class U, size_t Alignment>
+bool operator==(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&) { return true; }
+template <class T, class U, size_t Alignment>
+bool operator!=(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&) { return false; }
+
 // ****************************************
 // Static allocator for single items of a given type, e.g.
 //   using long_allocator = type_allocator<long>;
@@ -0,0 +1,234 @@
+// A compressed sequence is an immutable sequence of integers that is
+// stored in a compact, block-wise delta-encoded form. It is intended for
+// large sequences of sorted or clustered integers, such as graph adjacency
+// arrays or sorted id lists, whose processing is bound by memory bandwidth.
+// Operations decode the values on the fly, so they read a fraction of the
+// memory that the equivalent operations on a sequence<T> would.
+//
+// Example:
+//
+//   auto ids = parlay::tabulate(n, [](size_t i) -> uint64_t { return 3 * i; });
+//   auto c = parlay::compressed_sequence<uint64_t>(ids);
+//   auto total = c.reduce(parlay::addm<uint64_t>());
+//
+
+#ifndef PARLAY_COMPRESSED_SEQUENCE_H_
+#define PARLAY_COMPRESSED_SEQUENCE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include "monoid.h"
+#include "parallel.h"
+#include "range.h"
+#include "sequence.h"
+#include "slice.h"
+
+#include "internal/sequence_ops.h"
+
+namespace parlay {
+
+// Elements are grouped into blocks of block_size consecutive elements. Within
+// a block, each element is stored as the difference from the previous one (the
+// first one is stored as is), zigzag encoded so that small negative differences
+// are also small, and written as a variable-length byte code with seven bits
+// per byte. A sorted sequence with small gaps therefore takes one or two bytes
+// per element instead of sizeof(T).
+//
+// Blocks do not depend on each other, so they are encoded and decoded in
+// parallel, and any single block can be decoded without touching the others.
+template <typename T>
+class compressed_sequence {
+  static_assert(std::is_integral_v<T>, "compressed_sequence requires an integral value type");
+
+  // Differences are computed in unsigned arithmetic, which wraps
+  // around, so that decoding recovers every value exactly.
+  using U = std::make_unsigned_t<T>;
+  static constexpr size_t bits = 8 * sizeof(U);
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  // The number of elements in each block. Accessing a single
+  // element decodes at most this many elements.
+  static constexpr size_t block_size = 128;
+
+  compressed_sequence() : n(0), offsets(1, 0) {}
+
+  // Encode the given range of integers in parallel.
+  template<PARLAY_RANGE_TYPE R>
+  explicit compressed_sequence(const R& r) : n(parlay::size(r)) {
+    auto it = std::begin(r);
+    size_t nb = num_blocks();
+
+    // First pass computes the encoded size of each block ...
+    offsets = sequence<size_t>(nb + 1, 0);
+    parallel_for(0, nb, [&](size_t b) {
+      size_t s = b * block_size;
+      size_t e = (std::min)(s + block_size, n);
+      size_t len = 0;
+      U prev = 0;
+      for (size_t i = s; i < e; i++) {
+        U x = static_cast<U>(it[i]);
+        len += encoded_size(zigzag(static_cast<U>(x - prev)));
+        prev = x;
+      }
+      offsets[b] = len;
+    });
+    size_t total = internal::scan_inplace(make_slice(offsets), addm<size_t>());
+    assert(offsets[nb] == total);
+
+    // ... and the second pass writes each block into its place
+    bytes = sequence<uint8_t>::uninitialized(total);
+    parallel_for(0, nb, [&](size_t b) {
+      size_t s = b * block_size;
+      size_t e = (std::min)(s + block_size, n);
+      uint8_t* out = bytes.begin() + offsets[b];
+      U prev = 0;
+      for (size_t i = s; i < e; i++) {
+        U x = static_cast<U>(it[i]);
+        out = encode(zigzag(static_cast<U>(x - prev)), out);
+        prev = x;
+      }
+      assert(out == bytes.begin() + offsets[b + 1]);
+    });
+  }
+
+  // The number of elements
+  size_t size() const { return n; }
+
+  bool empty() const { return n == 0; }
+
+  size_t num_blocks() const { return internal::num_blocks(n, block_size); }
+
+  // The memory used by the compressed representation in bytes
+  size_t size_in_bytes() const {
+    return bytes.size() * sizeof(uint8_t) + offsets.size() * sizeof(size_t);
+  }
+
+  // Apply f to each element of block b, in order
+  template<typename F>
+  void decode_block(size_t b, F&& f) const {
+    assert(b < num_blocks());
+    size_t len = (std::min)(block_size, n - b * block_size);
+    const uint8_t* in = bytes.begin() + offsets[b];
+    U x = 0;
+    for (size_t i = 0; i < len; i++) {
+      U d;
+      in = decode(in, d);
+      x = static_cast<U>(x + unzigzag(d));
+      f(static_cast<T>(x));
+    }
+  }
+
+  // Return the i'th element. Decodes the block that contains it.
+  T operator[](size_t i) const {
+    assert(i < n);
+    size_t b = i / block_size;
+    size_t k = i - b * block_size;
+    const uint8_t* in = bytes.begin() + offsets[b];
+    U x = 0;
+    for (size_t j = 0; j <= k; j++) {
+      U d;
+      in = decode(in, d);
+      x = static_cast<U>(x + unzigzag(d));
+    }
+    return static_cast<T>(x);
+  }
+
+  // Decode the entire sequence in parallel
+  sequence<T> decode() const {
+    return map([](T x) { return x; });
+  }
+
+  // Return the sequence f(A[0]), f(A[1]), ..., f(A[n-1]), where A is the
+  // decoded sequence, without materializing A.
+  template<typename UnaryOp>
+  auto map(UnaryOp&& f) const {
+    using R = std::remove_cv_t<std::remove_reference_t<decltype(f(std::declval<T>()))>>;
+    auto out = sequence<R>::uninitialized(n);
+    parallel_for(0, num_blocks(), [&](size_t b) {
+      size_t i = b * block_size;
+      decode_block(b, [&](T x) { assign_uninitialized(out[i++], f(x)); });
+    });
+    return out;
+  }
+
+  // Compute m.f(...m.f(m.f(f(A[0]), f(A[1])), ...), f(A[n-1])), where A is the
+  // decoded sequence, decoding each block once while reducing over it.
+  template<typename UnaryOp, typename Monoid>
+  auto map_reduce(UnaryOp&& f, Monoid&& m) const {
+    using R = std::remove_cv_t<std::remove_reference_t<decltype(m.identity)>>;
+    size_t nb = num_blocks();
+    if (nb == 0) return R(m.identity);
+    auto sums = sequence<R>::from_function(nb, [&](size_t b) {
+      R r = m.identity;
+      decode_block(b, [&](T x) { r = m.f(r, f(x)); });
+      return r;
+    });
+    return internal::reduce(make_slice(sums), m);
+  }
+
+  // Reduce the decoded elements with respect to the monoid m
+  template<typename Monoid>
+  auto reduce(Monoid&& m) const {
+    return map_reduce([](T x) { return x; }, std::forward<Monoid>(m));
+  }
+
+ private:
+
+  static U zigzag(U d) {
+    return static_cast<U>(static_cast<U>(d << 1) ^ static_cast<U>(U{0} - (d >> (bits - 1))));
+  }
+
+  static U unzigzag(U z) {
+    return static_cast<U>((z >> 1) ^ static_cast<U>(U{0} - (z & 1)));
+  }
+
+  static size_t encoded_size(U v) {
+    size_t len = 1;
+    while (v >= 128) { v >>= 7; len++; }
+    return len;
+  }
+
+  static uint8_t* encode(U v, uint8_t* out) {
+    while (v >= 128) {
+      *out++ = static_cast<uint8_t>((v & 127) | 128);
+      v >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(v);
+    return out;
+  }
+
+  static const uint8_t* decode(const uint8_t* in, U& v) {
+    v = 0;
+    size_t shift = 0;
+    uint8_t c;
+    do {
+      c = *in++;
+      v |= static_cast<U>(static_cast<U>(c & 127) << shift);
+      shift += 7;
+    } while (c & 128);
+    return in;
+  }
+
+  size_t n;
+  sequence<size_t> offsets;   // The start of each block in bytes, plus the total length
+  sequence<uint8_t> bytes;
+};
+
+// Factory function that deduces the value type
+template<PARLAY_RANGE_TYPE R>
+auto compress(const R& r) {
+  return compressed_sequence<range_value_type_t<R>>(r);
+}
+
+}  // namespace parlay
+
+#endif  // PARLAY_COMPRESSED_SEQUENCE_H_
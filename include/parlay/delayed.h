@@ -0,0 +1,357 @@
+// Block-delayed views are lazily evaluated sequences that, unlike delayed
+// sequences, do not support random access. Instead, they are split into a
+// small number of blocks (a few per worker), each of which can be traversed
+// in order, independently of the others. This is enough to express operations
+// whose output positions depend on earlier elements, such as filter, scan and
+// flatten, without materializing their results.
+//
+// Stages of a pipeline are fused, so that, for example
+//
+//   auto v = parlay::delayed::filter(parlay::delayed::map(A, f), pred);
+//   auto sum = parlay::delayed::reduce(v, parlay::addm<long>());
+//
+// makes a single pass over A, and only allocates storage for one partial
+// result per block, rather than the two intermediate sequences that
+// parlay::filter(parlay::map(A, f), pred) would allocate.
+//
+// Any random-access range can be used as the input of a view. If it is
+// a temporary, the view takes ownership of it by moving it. Otherwise, the
+// view holds a reference to it, so it must remain alive as long as the view.
+//
+
+#ifndef PARLAY_DELAYED_H_
+#define PARLAY_DELAYED_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "monoid.h"
+#include "parallel.h"
+#include "range.h"
+#include "sequence.h"
+#include "slice.h"
+#include "utilities.h"
+
+#include "internal/sequence_ops.h"
+
+namespace parlay {
+namespace internal {
+
+// Base class of all block-delayed views, so that they
+// can be told apart from plain random-access ranges.
+//
+// A view V has a member type value_type, and the members
+//   size_t num_blocks() const
+//   void for_each_in_block(size_t b, F f) const
+// where the latter applies f to each element of the b'th block in order.
+struct block_view_base {};
+
+template<typename V>
+inline constexpr bool is_block_view_v = std::is_base_of_v<block_view_base, std::decay_t<V>>;
+
+// The number of blocks that a range of n elements is split into. A few
+// blocks per worker gives the scheduler room to balance the load, while
+// keeping the per-block storage of scans and reductions small.
+inline size_t num_view_blocks(size_t n) {
+  return (std::min)(num_blocks(n, _block_size), 8 * num_workers());
+}
+
+// A view of a random-access range
+template<typename Range>
+class range_block_view : public block_view_base {
+ public:
+  using value_type = range_value_type_t<Range>;
+
+  explicit range_block_view(Range&& _r)
+    : r(std::forward<Range>(_r)), n(parlay::size(r)), nb(num_view_blocks(n)) { }
+
+  size_t num_blocks() const { return nb; }
+
+  template<typename F>
+  void for_each_in_block(size_t b, F&& f) const {
+    auto it = std::begin(r);
+    size_t s = (b * n) / nb;
+    size_t e = ((b + 1) * n) / nb;
+    for (size_t i = s; i < e; i++) f(it[i]);
+  }
+
+ private:
+  Range r;
+  size_t n, nb;
+};
+
+template<typename V, typename UnaryOp>
+class map_view : public block_view_base {
+ public:
+  using value_type = std::remove_cv_t<std::remove_reference_t<
+    decltype(std::declval<const UnaryOp&>()(std::declval<typename V::value_type>()))>>;
+
+  map_view(V _v, UnaryOp _f) : v(std::move(_v)), f(std::move(_f)) { }
+
+  size_t num_blocks() const { return v.num_blocks(); }
+
+  template<typename F>
+  void for_each_in_block(size_t b, F&& g) const {
+    v.for_each_in_block(b, [&](auto&& x) { g(f(std::forward<decltype(x)>(x))); });
+  }
+
+ private:
+  V v;
+  UnaryOp f;
+};
+
+template<typename V, typename UnaryPred>
+class filter_view : public block_view_base {
+ public:
+  using value_type = typename V::value_type;
+
+  filter_view(V _v, UnaryPred _p) : v(std::move(_v)), p(std::move(_p)) { }
+
+  size_t num_blocks() const { return v.num_blocks(); }
+
+  template<typename F>
+  void for_each_in_block(size_t b, F&& g) const {
+    v.for_each_in_block(b, [&](auto&& x) { if (p(x)) g(std::forward<decltype(x)>(x)); });
+  }
+
+ private:
+  V v;
+  UnaryPred p;
+};
+
+template<typename V>
+class flatten_view : public block_view_base {
+ public:
+  using value_type = range_value_type_t<typename V::value_type>;
+
+  explicit flatten_view(V _v) : v(std::move(_v)) { }
+
+  size_t num_blocks() const { return v.num_blocks(); }
+
+  template<typename F>
+  void for_each_in_block(size_t b, F&& g) const {
+    v.for_each_in_block(b, [&](auto&& inner) {
+      for (auto&& y : inner) g(std::forward<decltype(y)>(y));
+    });
+  }
+
+ private:
+  V v;
+};
+
+// The pairs of corresponding elements of two random-access ranges
+template<typename Range1, typename Range2>
+class zip_view : public block_view_base {
+ public:
+  using value_type = std::pair<range_value_type_t<Range1>, range_value_type_t<Range2>>;
+
+  zip_view(Range1&& _r1, Range2&& _r2)
+    : r1(std::forward<Range1>(_r1)), r2(std::forward<Range2>(_r2)),
+      n((std::min)(parlay::size(r1), parlay::size(r2))), nb(num_view_blocks(n)) { }
+
+  size_t num_blocks() const { return nb; }
+
+  template<typename F>
+  void for_each_in_block(size_t b, F&& f) const {
+    auto it1 = std::begin(r1);
+    auto it2 = std::begin(r2);
+    size_t s = (b * n) / nb;
+    size_t e = ((b + 1) * n) / nb;
+    for (size_t i = s; i < e; i++) f(value_type(it1[i], it2[i]));
+  }
+
+ private:
+  Range1 r1;
+  Range2 r2;
+  size_t n, nb;
+};
+
+// A scan needs the total of all preceding blocks before it can produce
+// the elements of a block, so constructing the view computes the total
+// of each block (one pass over the input and O(num_blocks) storage). The
+// elements themselves are computed on demand.
+template<typename V, typename Monoid>
+class scan_view : public block_view_base {
+ public:
+  using value_type = typename Monoid::T;
+
+  scan_view(V _v, Monoid _m, bool _inclusive)
+    : v(std::move(_v)), m(std::move(_m)), inclusive(_inclusive) {
+    size_t nb = v.num_blocks();
+    offsets = sequence<value_type>::from_function(nb, [&](size_t b) {
+      value_type r = m.identity;
+      v.for_each_in_block(b, [&](auto&& x) { r = m.f(r, x); });
+      return r;
+    }, 1);
+    total = scan_inplace(make_slice(offsets), m);
+  }
+
+  size_t num_blocks() const { return v.num_blocks(); }
+
+  // The total of all of the elements
+  value_type get_total() const { return total; }
+
+  template<typename F>
+  void for_each_in_block(size_t b, F&& g) const {
+    value_type r = offsets[b];
+    if (inclusive) {
+      v.for_each_in_block(b, [&](auto&& x) { r = m.f(r, x); g(r); });
+    } else {
+      v.for_each_in_block(b, [&](auto&& x) { g(r); r = m.f(r, x); });
+    }
+  }
+
+ private:
+  V v;
+  Monoid m;
+  bool inclusive;
+  sequence<value_type> offsets;
+  value_type total;
+};
+
+// Turn r into a view. Views are returned as they are,
+// and random-access ranges are wrapped in a range_block_view
+template<typename R>
+auto to_block_view(R&& r) {
+  if constexpr (is_block_view_v<R>) {
+    return std::decay_t<R>(std::forward<R>(r));
+  } else {
+    return range_block_view<R>(std::forward<R>(r));
+  }
+}
+
+}  // namespace internal
+
+namespace delayed {
+
+// Return a view of the elements f(r[0]), f(r[1]), ..., f(r[n-1])
+template<typename R, typename UnaryOp>
+auto map(R&& r, UnaryOp f) {
+  auto v = internal::to_block_view(std::forward<R>(r));
+  return internal::map_view<decltype(v), UnaryOp>(std::move(v), std::move(f));
+}
+
+// Return a view of the elements x of r such that p(x) is true
+template<typename R, typename UnaryPred>
+auto filter(R&& r, UnaryPred p) {
+  auto v = internal::to_block_view(std::forward<R>(r));
+  return internal::filter_view<decltype(v), UnaryPred>(std::move(v), std::move(p));
+}
+
+// Return a view of the concatenation of the ranges in r
+template<typename R>
+auto flatten(R&& r) {
+  auto v = internal::to_block_view(std::forward<R>(r));
+  return internal::flatten_view<decltype(v)>(std::move(v));
+}
+
+// Return a view of the exclusive prefix sums of r with respect to
+// the monoid m. The total is available from the view's get_total().
+// This makes one pass over r to compute the total of each block.
+template<typename R, typename Monoid>
+auto scan(R&& r, Monoid m) {
+  auto v = internal::to_block_view(std::forward<R>(r));
+  return internal::scan_view<decltype(v), Monoid>(std::move(v), std::move(m), false);
+}
+
+template<typename R>
+auto scan(R&& r) {
+  using T = typename decltype(internal::to_block_view(std::forward<R>(r)))::value_type;
+  return scan(std::forward<R>(r), addm<T>());
+}
+
+// Return a view of the inclusive prefix sums of r with respect to the monoid m
+template<typename R, typename Monoid>
+auto scan_inclusive(R&& r, Monoid m) {
+  auto v = internal::to_block_view(std::forward<R>(r));
+  return internal::scan_view<decltype(v), Monoid>(std::move(v), std::move(m), true);
+}
+
+template<typename R>
+auto scan_inclusive(R&& r) {
+  using T = typename decltype(internal::to_block_view(std::forward<R>(r)))::value_type;
+  return scan_inclusive(std::forward<R>(r), addm<T>());
+}
+
+// Return a view of the pairs (r1[i], r2[i]) of two random-access ranges.
+// The length of the view is the length of the shorter range.
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2>
+auto zip(R1&& r1, R2&& r2) {
+  static_assert(!internal::is_block_view_v<R1> && !internal::is_block_view_v<R2>,
+    "zip requires random-access ranges, since the blocks of two views need not line up");
+  return internal::zip_view<R1, R2>(std::forward<R1>(r1), std::forward<R2>(r2));
+}
+
+// Apply f to each element of r. Elements in different blocks are
+// processed in parallel, and those within a block in order.
+template<typename R, typename UnaryFunction>
+void for_each(R&& r, UnaryFunction f) {
+  auto v = internal::to_block_view(std::forward<R>(r));
+  parallel_for(0, v.num_blocks(), [&](size_t b) {
+    v.for_each_in_block(b, f);
+  }, 1);
+}
+
+// Reduce the elements of r with respect to the monoid m
+template<typename R, typename Monoid>
+auto reduce(R&& r, Monoid m) {
+  using T = typename Monoid::T;
+  auto v = internal::to_block_view(std::forward<R>(r));
+  auto sums = sequence<T>::from_function(v.num_blocks(), [&](size_t b) {
+    T s = m.identity;
+    v.for_each_in_block(b, [&](auto&& x) { s = m.f(s, x); });
+    return s;
+  }, 1);
+  return internal::reduce(make_slice(sums), m);
+}
+
+template<typename R>
+auto reduce(R&& r) {
+  using T = typename decltype(internal::to_block_view(std::forward<R>(r)))::value_type;
+  return reduce(std::forward<R>(r), addm<T>());
+}
+
+// Return the number of elements of r
+template<typename R>
+size_t size(R&& r) {
+  auto v = internal::to_block_view(std::forward<R>(r));
+  auto counts = sequence<size_t>::from_function(v.num_blocks(), [&](size_t b) {
+    size_t c = 0;
+    v.for_each_in_block(b, [&](auto&&) { c++; });
+    return c;
+  }, 1);
+  return internal::reduce(make_slice(counts), addm<size_t>());
+}
+
+// Evaluate the elements of r and return them in a sequence. Each
+// block is evaluated once, into a buffer of its own, and the buffers
+// are then copied to their place in the output.
+template<typename R>
+auto to_sequence(R&& r) {
+  auto v = internal::to_block_view(std::forward<R>(r));
+  using T = typename decltype(v)::value_type;
+  size_t nb = v.num_blocks();
+  auto blocks = sequence<sequence<T>>::from_function(nb, [&](size_t b) {
+    sequence<T> out;
+    v.for_each_in_block(b, [&](auto&& x) { out.push_back(std::forward<decltype(x)>(x)); });
+    return out;
+  }, 1);
+  auto offsets = sequence<size_t>::from_function(nb, [&](size_t b) { return blocks[b].size(); });
+  size_t total = internal::scan_inplace(make_slice(offsets), addm<size_t>());
+  auto result = sequence<T>::uninitialized(total);
+  parallel_for(0, nb, [&](size_t b) {
+    auto out = result.begin() + offsets[b];
+    for (size_t i = 0; i < blocks[b].size(); i++)
+      assign_uninitialized(out[i], std::move(blocks[b][i]));
+  }, 1);
+  return result;
+}
+
+}  // namespace delayed
+}  // namespace parlay
+
+#endif  // PARLAY_DELAYED_H_
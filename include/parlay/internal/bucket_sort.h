@@ -160,6 +160,16 @@ void bucket_sort(slice<Iterator, Iterator> in, BinaryOp f, bool stable = false)
   bucket_sort_r(make_slice(in), make_slice(tmp), f, stable, true);
 }
 
+// Sequential in-place sort, used as the base case of the sample sorts
+template <typename Iterator, typename Compare>
+void seq_sort_inplace(slice<Iterator, Iterator> A, const Compare& less, bool stable) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  if (((sizeof(value_type) > 8) || std::is_pointer<value_type>::value) && !stable)
+    quicksort(A.begin(), A.size(), less);
+  else
+    bucket_sort(A, less, stable);
+}
+
 }  // namespace internal
 }  // namespace parlay
 
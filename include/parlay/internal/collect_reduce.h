@@ -46,7 +46,7 @@ void seq_collect_reduce_few(Seq const &A, OutSeq &&Out, Key const &get_key,
     assign_uninitialized(Out[i],monoid.identity);
   for (size_t j = 0; j < n; j++) {
     size_t k = get_key(A[j]);
-    Out[k] = monoid.f(Out[k], get_value(A[j]));
+    combine_into(monoid, Out[k], get_value(A[j]));
   }
 }
 
@@ -103,8 +103,8 @@ auto collect_reduce_few(Seq const &A, Key const &get_key,
                [&](size_t i) {
                  val_type o_val = monoid.identity;
                  for (size_t j = 0; j < num_blocks; j++)
-                   o_val = monoid.f(o_val, OutM[i + j * num_buckets]);
-                 Out[i] = o_val;
+                   combine_into(monoid, o_val, std::move(OutM[i + j * num_buckets]));
+                 Out[i] = std::move(o_val);
                },
                1);
   return Out;
@@ -254,7 +254,7 @@ auto collect_reduce(Seq const &A, Key const &get_key, Value const &get_value,
                  if (i < cut)
                    for (size_t i = start; i < end; i++) {
                      size_t j = get_key(B[i]);
-                     sums[j] = monoid.f(sums[j], get_value(B[i]));
+                     combine_into(monoid, sums[j], get_value(B[i]));
                    }
 
                  // large blocks have indices in top half
@@ -292,7 +292,7 @@ auto collect_reduce(Seq const &A, Key const &get_key, Value const &get_value,
       while (flags[k] && !hasheq.equal(table[k].first, key))
 	k = (k + 1 == table_size) ? 0 : k + 1;
       if (flags[k]) {
-	table[k].second = monoid.f(table[k].second, get_val(A[j]));
+	combine_into(monoid, table[k].second, get_val(A[j]));
       } else {
 	flags[k] = true;
 	count++;
@@ -313,7 +313,7 @@ auto collect_reduce(Seq const &A, Key const &get_key, Value const &get_value,
       flags[j] = true;
       count++;
       assign_uninitialized(table[j],
-			   result_type(get_key(Heavy[0]), val));
+			   result_type(get_key(Heavy[0]), std::move(val)));
     }
 
     // pack non-empty entries of table into result sequence
@@ -426,7 +426,7 @@ auto collect_reduce_sparse(slice<Iterator,Iterator> A,
   auto group_by_and_combine(R const &A, Monoid const &monoid,
 			    Hash hash = {}, Equal equal = {}) { 
     auto get_key = [] (const auto& a) {return a.first;};
-    auto get_val = [] (const auto& a) {return a.second;};
+    auto get_val = [] (const auto& a) -> const auto& {return a.second;};
     return collect_reduce_sparse(make_slice(A), hasheq(hash,equal),
 				 get_key, get_val, monoid);
   }
@@ -0,0 +1,114 @@
+#ifndef PARLAY_INTERNAL_FILE_ALLOCATOR_H_
+#define PARLAY_INTERNAL_FILE_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <new>
+#include <string>
+
+#include "file_map.h"     // for PARLAY_POSIX_FILE_MAP
+
+#include "../alloc.h"
+
+#if defined(PARLAY_POSIX_FILE_MAP) && !defined(PARLAY_USE_FALLBACK_FILE_ALLOCATOR)
+#include "posix/file_allocator_impl_posix.h"
+#define PARLAY_FILE_BACKED_ALLOCATOR
+#endif
+
+namespace parlay {
+namespace internal {
+
+// Allocations of at least this many bytes are backed by a file. Smaller
+// ones are not worth a file and a mapping each, so they go to the default
+// allocator instead.
+constexpr const size_t _file_allocator_threshold = (1 << 20);
+
+inline std::string default_file_allocator_directory() {
+  if (const char* dir = std::getenv("PARLAY_FILE_ALLOCATOR_DIR")) return dir;
+  if (const char* dir = std::getenv("TMPDIR")) return dir;
+  return "/tmp";
+}
+
+inline std::string& file_allocator_directory_ref() {
+  static std::string directory = default_file_allocator_directory();
+  return directory;
+}
+
+inline void* small_allocate(size_t n) {
+#ifndef PARLAY_USE_STD_ALLOC
+  return get_default_allocator().allocate(n);
+#else
+  return ::operator new(n);
+#endif
+}
+
+inline void small_deallocate(void* p, size_t n) {
+#ifndef PARLAY_USE_STD_ALLOC
+  get_default_allocator().deallocate(p, n);
+#else
+  ::operator delete(p, n);
+#endif
+}
+
+}  // namespace internal
+
+// Set the directory in which the file_allocator creates its backing files.
+// It should be on a fast local disk. By default, the directory is taken from
+// the environment variable PARLAY_FILE_ALLOCATOR_DIR, then TMPDIR, and
+// otherwise is /tmp. Should not be changed while allocations are being made.
+inline void set_file_allocator_directory(const std::string& directory) {
+  internal::file_allocator_directory_ref() = directory;
+}
+
+inline const std::string& file_allocator_directory() {
+  return internal::file_allocator_directory_ref();
+}
+
+// ****************************************
+// An allocator whose large blocks live in memory-mapped files rather than
+// anonymous memory. Each large allocation is a sparse file mapped with
+// MAP_SHARED, so the kernel can write its pages back to disk through the page
+// cache, and a sequence can hold more data than fits in main memory, e.g.
+//    parlay::sequence<long, parlay::file_allocator<long>> big(n);
+//
+// The backing files are unlinked as soon as they are mapped, so nothing
+// is left behind on disk after the memory is freed. On platforms without
+// memory-mapped files (or if PARLAY_USE_FALLBACK_FILE_ALLOCATOR is defined),
+// this behaves the same as the default allocator.
+// ****************************************
+
+template <typename T>
+struct file_allocator {
+  using value_type = T;
+
+  T* allocate(size_t n) {
+    size_t bytes = n * sizeof(T);
+#ifdef PARLAY_FILE_BACKED_ALLOCATOR
+    if (bytes >= internal::_file_allocator_threshold)
+      return static_cast<T*>(internal::file_backed_allocate(file_allocator_directory(), bytes));
+#endif
+    return static_cast<T*>(internal::small_allocate(bytes));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    size_t bytes = n * sizeof(T);
+#ifdef PARLAY_FILE_BACKED_ALLOCATOR
+    if (bytes >= internal::_file_allocator_threshold)
+      return internal::file_backed_deallocate(static_cast<void*>(ptr), bytes);
+#endif
+    internal::small_deallocate(static_cast<void*>(ptr), bytes);
+  }
+
+  constexpr file_allocator() = default;
+  template <class U> constexpr file_allocator(const file_allocator<U>&) noexcept { }
+};
+
+template <class T, class U>
+bool operator==(const file_allocator<T>&, const file_allocator<U>&) { return true; }
+template <class T, class U>
+bool operator!=(const file_allocator<T>&, const file_allocator<U>&) { return false; }
+
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_FILE_ALLOCATOR_H_
@@ -6,7 +6,11 @@
 #include <cstdint>
 #include <cstdio>
 
+#include <limits>
+#include <type_traits>
+
 #include "counting_sort.h"
+#include "ips4o.h"
 #include "sequence_ops.h"
 #include "quicksort.h"
 #include "uninitialized_sequence.h"
@@ -323,10 +327,59 @@ sequence<size_t> integer_sort_(slice<InIterator, InIterator> In,
     In, Out, Tmp, g, bits, num_buckets);
 }
 
+// An in-place MSD radix sort. Each level distributes the elements by the
+// next radix digit of their keys with the block-based distribution of the
+// in-place sample sort (see ips4o.h), so the extra memory is O(P k b) for
+// P workers, k buckets and blocks of b elements, plus a buffer for each
+// sequential base case. Unlike integer_sort_r, it is not stable.
+template <typename Iterator, typename Get_Key>
+void radix_sort_inplace_(slice<Iterator, Iterator> In, Get_Key const &g, size_t key_bits) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  size_t n = In.size();
+  if (key_bits == 0 || n <= 1) return;
+  if (n < IPS4O_BASE_CASE) {
+    // Only sort on the bits that differ between the keys of this bucket
+    using key_type = std::decay_t<decltype(g(In[0]))>;
+    key_type lo = g(In[0]), hi = lo;
+    for (size_t i = 1; i < n; i++) {
+      key_type k = g(In[i]);
+      lo = (std::min)(lo, k);
+      hi = (std::max)(hi, k);
+    }
+    if (lo == hi) return;
+    auto Tmp = uninitialized_sequence<value_type>(n);
+    auto offset_key = [&](const value_type& x) { return static_cast<key_type>(g(x) - lo); };
+    size_t range = static_cast<size_t>(hi - lo);
+    size_t bits = (range == (std::numeric_limits<size_t>::max)()) ? 64 : log2_up(range + 1);
+    seq_radix_sort_(In, make_slice(Tmp), offset_key, bits, true);
+    return;
+  }
+  size_t bits = (std::min)(radix, key_bits);
+  size_t shift_bits = key_bits - bits;
+  ips4o_radix_classifier<Get_Key> classify(g, shift_bits, bits);
+  auto offsets = ips4o_distribute(In, classify);
+  parallel_for(0, classify.num_buckets(), [&](size_t i) {
+    radix_sort_inplace_(In.cut(offsets[i], offsets[i + 1]), g, shift_bits);
+  }, 1);
+}
+
+// Sorts In in place by the keys given by g. With fl_low_memory, uses the
+// in-place radix sort, which is not stable, instead of a buffer of size n.
 template <typename Iterator, typename Get_Key>
 void integer_sort_inplace(slice<Iterator, Iterator> In,
-                          Get_Key const &g, size_t bits = 0) {
+                          Get_Key const &g, size_t bits = 0,
+                          flags fl = no_flag) {
   using value_type = typename slice<Iterator, Iterator>::value_type;
+  if (fl & fl_low_memory) {
+    if (bits == 0) {
+      auto get_key = [&](size_t i) { return static_cast<size_t>(g(In[i])); };
+      auto keys = delayed_seq<size_t>(In.size(), get_key);
+      size_t max_key = internal::reduce(make_slice(keys), maxm<size_t>());
+      bits = (max_key == (std::numeric_limits<size_t>::max)()) ? 64 : log2_up(max_key + 1);
+    }
+    radix_sort_inplace_(In, g, bits);
+    return;
+  }
   auto Tmp = internal::uninitialized_sequence<value_type>(In.size());
   integer_sort_<std::true_type, uninitialized_relocate_tag>(In, make_slice(Tmp), In, g, bits, 0);
 }
@@ -0,0 +1,400 @@
+// An in-place parallel super scalar sample sort, following:
+//
+// Engineering In-place (Shared-memory) Sorting Algorithms.
+// Michael Axtmann, Sascha Witt, Daniel Ferizovic and Peter Sanders.
+// ACM Transactions on Parallel Computing, 2022
+//
+// Each level of recursion distributes the elements into up to 256 buckets
+// (plus as many equality buckets) using O(P k b) extra memory for P tasks,
+// k buckets and blocks of b elements, rather than a copy of the input. The
+// same distribution, with buckets given by a radix digit instead of by
+// splitters, gives the in-place radix sort of the paper (IPS2Ra), which is
+// used by integer_sort.h.
+
+#ifndef PARLAY_INTERNAL_IPS4O_H_
+#define PARLAY_INTERNAL_IPS4O_H_
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "bucket_sort.h"
+#include "uninitialized_sequence.h"
+
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// Inputs smaller than this are sorted sequentially
+constexpr size_t IPS4O_BASE_CASE = 16384;
+constexpr size_t IPS4O_MAX_LOG_BUCKETS = 8;
+constexpr size_t IPS4O_BLOCK_BYTES = 2048;
+constexpr size_t IPS4O_BATCH = 16;
+
+// Relocates n elements from [from, from + n) to [to, to + n) sequentially
+template <typename It1, typename It2>
+void ips4o_relocate(It1 to, It2 from, size_t n) {
+  using T = typename std::iterator_traits<It1>::value_type;
+  if constexpr (is_trivially_relocatable_v<T> && is_contiguous_iterator_v<It1> && is_contiguous_iterator_v<It2>) {
+    if (n > 0) std::memcpy(static_cast<void*>(std::addressof(*to)), static_cast<void*>(std::addressof(*from)), n * sizeof(T));
+  } else {
+    for (size_t i = 0; i < n; i++) uninitialized_relocate(std::addressof(to[i]), std::addressof(from[i]));
+  }
+}
+
+// Classifies elements into buckets with a branchless search in a complete
+// binary tree of splitters stored in level order. If some splitters were
+// equal in the sample, each splitter also gets an equality bucket for the
+// elements equal to it, which do not need to be sorted any further, so that
+// inputs with many duplicates are still split evenly.
+template <typename T, typename Compare>
+class ips4o_classifier {
+ public:
+  ips4o_classifier(sequence<T> splitters, size_t log_k, const Compare& less_)
+      : log_buckets(log_k), k(size_t{1} << log_k), less(less_) {
+    size_t m = splitters.size();
+    use_equality = m < k - 1;
+    // Pad to k - 1 splitters by repeating the largest one
+    sorted = sequence<T>::from_function(k - 1, [&](size_t i) { return splitters[(std::min)(i, m - 1)]; });
+    tree = sequence<T>::from_function(k, [&](size_t j) {
+      if (j == 0) return sorted[0];
+      // The in-order rank of node j of a complete tree with k - 1 nodes
+      size_t level = log2_up(j + 1) - 1;
+      size_t height = log_buckets - 1 - level;
+      size_t first = (size_t{1} << height) - 1;
+      size_t offset = j - (size_t{1} << level);
+      return sorted[first + offset * (size_t{1} << (height + 1))];
+    });
+  }
+
+  size_t num_buckets() const { return use_equality ? 2 * k - 1 : k; }
+
+  bool is_equality_bucket(size_t b) const { return use_equality && (b % 2 == 1); }
+
+  size_t operator()(const T& x) const {
+    size_t j = 1;
+    for (size_t l = 0; l < log_buckets; l++) j = 2 * j + less(tree[j], x);
+    return finish(j - k, x);
+  }
+
+  // Classifies the n <= IPS4O_BATCH elements at A[0, n) into buckets[0, n).
+  // Descending the tree for several elements at once keeps many independent
+  // comparisons in flight.
+  template <typename Iterator>
+  void classify_batch(Iterator A, size_t n, size_t* buckets) const {
+    size_t j[IPS4O_BATCH];
+    for (size_t u = 0; u < n; u++) j[u] = 1;
+    for (size_t l = 0; l < log_buckets; l++) {
+      for (size_t u = 0; u < n; u++) j[u] = 2 * j[u] + less(tree[j[u]], A[u]);
+    }
+    for (size_t u = 0; u < n; u++) buckets[u] = finish(j[u] - k, A[u]);
+  }
+
+ private:
+  size_t finish(size_t i, const T& x) const {
+    if (!use_equality) return i;
+    return 2 * i + (i < k - 1 && !less(x, sorted[(std::min)(i, k - 2)]));
+  }
+
+  size_t log_buckets, k;
+  bool use_equality;
+  const Compare& less;
+  sequence<T> sorted;
+  sequence<T> tree;
+};
+
+// Classifies elements by the radix digit of their integer key, given by g,
+// that starts at bit shift, for an in-place MSD radix sort
+template <typename GetKey>
+class ips4o_radix_classifier {
+ public:
+  ips4o_radix_classifier(const GetKey& g_, size_t shift_, size_t bits)
+      : g(g_), shift(shift_), mask((size_t{1} << bits) - 1) {}
+
+  size_t num_buckets() const { return mask + 1; }
+
+  template <typename T>
+  size_t operator()(const T& x) const { return static_cast<size_t>(g(x) >> shift) & mask; }
+
+  template <typename Iterator>
+  void classify_batch(Iterator A, size_t n, size_t* buckets) const {
+    for (size_t u = 0; u < n; u++) buckets[u] = (*this)(A[u]);
+  }
+
+ private:
+  const GetKey& g;
+  size_t shift, mask;
+};
+
+// Distributes the elements of A into the buckets given by classify in place,
+// and returns the offsets at which the buckets start, followed by n. The
+// classifier must provide num_buckets(), operator() and classify_batch.
+//
+// 1. Local classification: A is cut into one stripe per task. Each task
+//    moves the elements of its stripe into one buffer block per bucket, and
+//    whenever a buffer fills up, writes it back to the front of the stripe,
+//    which has already been read. Each stripe then starts with full blocks,
+//    each of a single bucket, followed by empty space.
+// 2. Block permutation: the boundaries of the buckets are rounded up to
+//    block boundaries, and the full blocks within the range of each bucket
+//    are moved to its front. Each bucket has a write pointer to its next
+//    block to place, and a read pointer to its last unread full block, and
+//    the tasks repeatedly read a block, and swap it into the next free slot
+//    of its bucket, continuing with the block that was there, until a block
+//    lands in an empty slot. A block whose slot would run past the end of A
+//    goes to an overflow buffer instead.
+// 3. Cleanup: the bucket boundaries are not block aligned, so the last block
+//    of a bucket may spill into the next bucket. The spilled elements, the
+//    overflow buffer and the partially filled buffers of the tasks are then
+//    moved into the gaps at the ends of their buckets.
+template <typename Iterator, typename Classifier>
+sequence<size_t> ips4o_distribute(slice<Iterator, Iterator> A, const Classifier& classify) {
+  using T = typename slice<Iterator, Iterator>::value_type;
+  size_t n = A.size();
+  constexpr size_t b = (std::max)(size_t{1}, IPS4O_BLOCK_BYTES / sizeof(T));
+  size_t nb = classify.num_buckets();
+
+  // ------------------------ Local classification --------------------------
+  size_t num_slots = (n + b - 1) / b;
+  assert(num_slots < (uint64_t{1} << 32));
+  size_t num_tasks = (std::min)(num_workers(), (std::max)(size_t{1}, n / (nb * b)));
+  size_t stripe = (num_slots + num_tasks - 1) / num_tasks;  // in blocks
+  auto buffers = uninitialized_sequence<T>(num_tasks * nb * b);
+  auto buffer_sizes = sequence<size_t>(num_tasks * nb, 0);
+  auto block_counts = sequence<size_t>(num_tasks * nb, 0);
+  auto full_blocks = sequence<size_t>(num_tasks, 0);
+
+  parallel_for(0, num_tasks, [&](size_t t) {
+    size_t start = (std::min)(n, t * stripe * b);
+    size_t end = (std::min)(n, (t + 1) * stripe * b);
+    size_t write = start;
+    size_t* sizes = &buffer_sizes[t * nb];
+    size_t* counts = &block_counts[t * nb];
+    T* buffer = buffers.begin() + t * nb * b;
+    size_t buckets[IPS4O_BATCH];
+    for (size_t i = start; i < end; i += IPS4O_BATCH) {
+      size_t m = (std::min)(IPS4O_BATCH, end - i);
+      classify.classify_batch(A.begin() + i, m, buckets);
+      for (size_t u = 0; u < m; u++) {
+        size_t c = buckets[u];
+        uninitialized_relocate(buffer + c * b + sizes[c], std::addressof(A[i + u]));
+        if (++sizes[c] == b) {
+          ips4o_relocate(A.begin() + write, buffer + c * b, b);
+          write += b;
+          sizes[c] = 0;
+          counts[c]++;
+        }
+      }
+    }
+    full_blocks[t] = (write - start) / b;
+  }, 1);
+
+  // The number of elements and of full blocks of each bucket, and where the
+  // buckets start, in elements and in (rounded up) blocks
+  auto bucket_sizes = sequence<size_t>::from_function(nb, [&](size_t c) {
+    size_t total = 0;
+    for (size_t t = 0; t < num_tasks; t++) total += block_counts[t * nb + c] * b + buffer_sizes[t * nb + c];
+    return total;
+  });
+  auto bucket_blocks = sequence<size_t>::from_function(nb, [&](size_t c) {
+    size_t total = 0;
+    for (size_t t = 0; t < num_tasks; t++) total += block_counts[t * nb + c];
+    return total;
+  });
+  auto bucket_starts = sequence<size_t>(nb + 1);
+  bucket_starts[0] = 0;
+  for (size_t c = 0; c < nb; c++) bucket_starts[c + 1] = bucket_starts[c] + bucket_sizes[c];
+  assert(bucket_starts[nb] == n);
+  auto slot_starts = sequence<size_t>::from_function(nb + 1, [&](size_t c) {
+    return (std::min)(num_slots, (bucket_starts[c] + b - 1) / b); });
+
+  // ------------------------- Block permutation ----------------------------
+  auto is_full = [&](size_t s) { return s - (s / stripe) * stripe < full_blocks[s / stripe]; };
+  auto block = [&](size_t s) { return A.begin() + s * b; };
+
+  // Move the full blocks in the range of each bucket to its front. The
+  // write and read pointers of a bucket are packed into one word, so that
+  // both can be read and updated together atomically.
+  auto pointers = sequence<std::atomic<uint64_t>>(nb);
+  auto reading = sequence<std::atomic<size_t>>(nb);
+  parallel_for(0, nb, [&](size_t c) {
+    size_t lo = slot_starts[c], hi = slot_starts[c + 1];
+    size_t l = lo, r = hi;
+    while (true) {
+      while (l < r && is_full(l)) l++;
+      while (l < r && !is_full(r - 1)) r--;
+      if (l >= r) break;
+      ips4o_relocate(block(l), block(r - 1), b);
+      l++;
+      r--;
+    }
+    size_t num_full = 0;
+    for (size_t s = lo; s < hi; s++) num_full += is_full(s);
+    pointers[c].store((uint64_t{lo} << 32) | (lo + num_full));
+    reading[c].store(0);
+  }, 1);
+
+  auto overflow = uninitialized_sequence<T>(b);
+  auto swap_buffers = uninitialized_sequence<T>(num_tasks * 2 * b);
+
+  // Pops the last unread full block of bucket c, if any
+  auto pop = [&](size_t c, size_t& slot) {
+    reading[c].fetch_add(1);
+    uint64_t p = pointers[c].load();
+    while (true) {
+      uint64_t w = p >> 32, e = p & 0xFFFFFFFF;
+      if (e <= w) {
+        reading[c].fetch_sub(1);
+        return false;
+      }
+      if (pointers[c].compare_exchange_weak(p, (w << 32) | (e - 1))) {
+        slot = e - 1;
+        return true;
+      }
+    }
+  };
+
+  parallel_for(0, num_tasks, [&](size_t t) {
+    T* current = swap_buffers.begin() + 2 * t * b;
+    T* other = current + b;
+    size_t first = t * nb / num_tasks;
+    for (size_t r = 0; r < nb; r++) {
+      size_t c = (first + r) % nb;
+      size_t slot;
+      while (pop(c, slot)) {
+        ips4o_relocate(current, block(slot), b);
+        reading[c].fetch_sub(1);
+        while (true) {
+          size_t dest = classify(current[0]);
+          uint64_t p = pointers[dest].fetch_add(uint64_t{1} << 32);
+          uint64_t w = p >> 32, e = p & 0xFFFFFFFF;
+          if (w < e) {
+            // The slot holds a block that has not been read yet
+            ips4o_relocate(other, block(w), b);
+            ips4o_relocate(block(w), current, b);
+            std::swap(current, other);
+          } else {
+            // The slot is empty, but may still be being read
+            for (size_t tries = 0; reading[dest].load() != 0; tries++) {
+              if (tries >= 1000) std::this_thread::yield();
+            }
+            if ((w + 1) * b > n) ips4o_relocate(overflow.begin(), current, b);
+            else ips4o_relocate(block(w), current, b);
+            break;
+          }
+        }
+      }
+    }
+  }, 1);
+
+  // ------------------------------- Cleanup --------------------------------
+  // Element i of the full blocks of a bucket, which may be in the overflow buffer
+  auto placed = [&](size_t i) -> T* {
+    size_t last = (num_slots - 1) * b;
+    if (n % b != 0 && i >= last) return overflow.begin() + (i - last);
+    return std::addressof(A[i]);
+  };
+
+  // Move the elements of the full blocks of each bucket that are past its
+  // end, or in the overflow buffer, out of the way of the next bucket
+  auto spilled = uninitialized_sequence<T>(nb * b);
+  auto num_spilled = sequence<size_t>(nb, 0);
+  parallel_for(0, nb, [&](size_t c) {
+    if (bucket_blocks[c] == 0) return;
+    size_t end = bucket_starts[c + 1];
+    size_t blocks_start = slot_starts[c] * b;
+    size_t blocks_end = blocks_start + bucket_blocks[c] * b;
+    bool in_overflow = blocks_end > n;
+    if (in_overflow) {
+      for (size_t i = blocks_end - b; i < end; i++) uninitialized_relocate(std::addressof(A[i]), placed(i));
+    }
+    for (size_t i = (std::max)(end, blocks_start); i < blocks_end; i++) {
+      uninitialized_relocate(spilled.begin() + c * b + num_spilled[c]++, placed(i));
+    }
+  }, 1);
+
+  // Fill the gaps at the start and end of each bucket with its spilled
+  // elements and the contents of its buffers
+  parallel_for(0, nb, [&](size_t c) {
+    size_t start = bucket_starts[c], end = bucket_starts[c + 1];
+    size_t blocks_start = (std::min)(end, slot_starts[c] * b);
+    size_t blocks_end = (std::min)(end, blocks_start + bucket_blocks[c] * b);
+    if (bucket_blocks[c] == 0) blocks_start = blocks_end = end;
+    size_t gap = start;
+    auto fill = [&](T* from, size_t count) {
+      for (size_t i = 0; i < count; i++) {
+        if (gap == blocks_start) gap = blocks_end;
+        uninitialized_relocate(std::addressof(A[gap++]), from + i);
+      }
+    };
+    fill(spilled.begin() + c * b, num_spilled[c]);
+    for (size_t t = 0; t < num_tasks; t++) {
+      fill(buffers.begin() + (t * nb + c) * b, buffer_sizes[t * nb + c]);
+    }
+    assert(gap == end || (gap == blocks_start && blocks_end == end));
+  }, 1);
+
+  return bucket_starts;
+}
+
+template <typename Iterator, typename Compare>
+void ips4o_sort_inplace(slice<Iterator, Iterator> A, const Compare& less);
+
+// One level of the sort: a random sample is swapped to the front of A and
+// sorted, and evenly spaced splitters are copied out of it. The elements
+// are then distributed around the splitters, and the buckets are sorted
+// recursively.
+template <typename Iterator, typename Compare>
+void ips4o_sort_level(slice<Iterator, Iterator> A, const Compare& less) {
+  using T = typename slice<Iterator, Iterator>::value_type;
+  size_t n = A.size();
+  size_t log_k = (std::min)(IPS4O_MAX_LOG_BUCKETS, (std::max)(size_t{1}, log2_up(n / (IPS4O_BASE_CASE / 4))));
+  size_t k = size_t{1} << log_k;
+  size_t oversampling = (std::max)(size_t{1}, static_cast<size_t>(0.2 * std::log2(static_cast<double>(n))));
+  size_t num_samples = (std::min)(n, oversampling * k - 1);
+  for (size_t i = 0; i < num_samples; i++) {
+    size_t j = i + hash64(n + i) % (n - i);
+    std::swap(A[i], A[j]);
+  }
+  seq_sort_inplace(A.cut(0, num_samples), less, false);
+  size_t splitter_ids[size_t{1} << IPS4O_MAX_LOG_BUCKETS];
+  size_t num_splitters = 0;
+  for (size_t i = 1; i < k; i++) {
+    size_t id = (std::min)(num_samples, i * oversampling) - 1;
+    if (num_splitters == 0 || less(A[splitter_ids[num_splitters - 1]], A[id])) splitter_ids[num_splitters++] = id;
+  }
+  auto splitters = sequence<T>::from_function(num_splitters, [&](size_t i) { return A[splitter_ids[i]]; });
+  ips4o_classifier<T, Compare> classify(std::move(splitters), log_k, less);
+
+  auto bucket_starts = ips4o_distribute(A, classify);
+  parallel_for(0, classify.num_buckets(), [&](size_t c) {
+    if (classify.is_equality_bucket(c)) return;
+    ips4o_sort_inplace(A.cut(bucket_starts[c], bucket_starts[c + 1]), less);
+  }, 1);
+}
+
+// Sorts A in place. Only moves the elements, but copies up to 255 of them
+// as splitters, so the elements must be copy constructible.
+template <typename Iterator, typename Compare>
+void ips4o_sort_inplace(slice<Iterator, Iterator> A, const Compare& less) {
+  if (A.size() < IPS4O_BASE_CASE) seq_sort_inplace(A, less, false);
+  else ips4o_sort_level(A, less);
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_IPS4O_H_
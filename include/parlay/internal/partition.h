@@ -0,0 +1,140 @@
+
+#ifndef PARLAY_INTERNAL_PARTITION_H_
+#define PARLAY_INTERNAL_PARTITION_H_
+
+#include <cassert>
+#include <cstddef>
+
+#include <algorithm>
+#include <functional>
+#include <tuple>
+#include <utility>
+
+#include "merge.h"
+#include "sequence_ops.h"
+
+#include "../delayed_sequence.h"
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// In-place parallel partition. Counting the elements that satisfy the
+// predicate gives the split point t. The elements before t that do not
+// satisfy it and the elements after t that do are misplaced, and there are
+// equally many of each, so the partition is done by swapping the i'th
+// misplaced element on the left with the i'th misplaced element on the
+// right, for each i.
+//
+// Both sides are cut into blocks, and the misplaced elements of each block
+// are counted and scanned to give their ranks. The ranks are then cut at
+// the boundaries of the blocks on both sides into pieces, each of which
+// pairs up misplaced elements from one block on the left and one block on
+// the right, and the pieces are swapped in parallel. Where each piece starts
+// is found before any elements are swapped, since finding it reads elements
+// that other pieces of the same block swap.
+//
+// The extra memory is a few words per block. The predicate is evaluated
+// up to three times per element, so it should be cheap, and it must give
+// the same answer for an element wherever it is.
+
+constexpr const size_t _partition_base = 1 << 14;
+
+// Returns the index of the element of A that has the given rank among
+// those for which misplaced returns true. Offsets holds the number of
+// such elements before each block of A.
+template <typename Slice, typename Pred>
+size_t find_misplaced(const Slice& A, const sequence<size_t>& Offsets, size_t rank,
+                      const Pred& misplaced) {
+  size_t b = std::upper_bound(Offsets.begin(), Offsets.end(), rank) - Offsets.begin() - 1;
+  size_t skip = rank - Offsets[b];
+  size_t i = b * _block_size;
+  while (true) {
+    if (misplaced(A[i])) {
+      if (skip == 0) return i;
+      skip--;
+    }
+    i++;
+  }
+}
+
+// Counts the elements of each block of A for which misplaced returns true.
+// Returns the number of them before each block, and the total.
+template <typename Slice, typename Pred>
+std::pair<sequence<size_t>, size_t> misplaced_offsets(const Slice& A, const Pred& misplaced) {
+  size_t n = A.size();
+  sequence<size_t> Offsets(num_blocks(n, _block_size));
+  sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
+    size_t c = 0;
+    for (size_t j = s; j < e; j++) c += misplaced(A[j]);
+    Offsets[i] = c;
+  });
+  size_t total = scan_inplace(make_slice(Offsets), addm<size_t>());
+  return std::make_pair(std::move(Offsets), total);
+}
+
+// Rearranges A such that the elements for which f returns true precede
+// those for which it returns false, and returns the number of the former.
+// The relative order of the elements in each part is not preserved.
+template <typename Iterator, typename UnaryPred>
+size_t partition(slice<Iterator, Iterator> A, const UnaryPred& f) {
+  size_t n = A.size();
+  if (n < _partition_base) {
+    return std::partition(A.begin(), A.end(), f) - A.begin();
+  }
+
+  size_t t = internal::reduce(delayed_seq<size_t>(n, [&](size_t i) -> size_t {
+    return f(A[i]); }), addm<size_t>());
+  auto L = A.cut(0, t);
+  auto R = A.cut(t, n);
+  auto misplaced_left = [&](const auto& x) -> bool { return !f(x); };
+  auto misplaced_right = [&](const auto& x) -> bool { return f(x); };
+  sequence<size_t> OffsetsL, OffsetsR;
+  size_t m;
+  [[maybe_unused]] size_t mR;
+  std::tie(OffsetsL, m) = misplaced_offsets(L, misplaced_left);
+  std::tie(OffsetsR, mR) = misplaced_offsets(R, misplaced_right);
+  assert(m == mR);
+  if (m == 0) return t;
+
+  // Cut the ranks at the first rank of every block on either side
+  auto cuts = merge(make_slice(OffsetsL), make_slice(OffsetsR), std::less<size_t>());
+  size_t num_pieces = cuts.size();
+  auto starts = sequence<std::pair<size_t, size_t>>::from_function(num_pieces, [&](size_t p) {
+    size_t rank = cuts[p];
+    size_t end = (p + 1 < num_pieces) ? cuts[p + 1] : m;
+    if (rank == end) return std::make_pair(size_t{0}, size_t{0});
+    return std::make_pair(find_misplaced(L, OffsetsL, rank, misplaced_left),
+                          find_misplaced(R, OffsetsR, rank, misplaced_right));
+  });
+
+  // A piece has at most one block of misplaced elements on each side. Their
+  // positions are collected without branching on the predicate, then swapped.
+  parallel_for(0, num_pieces, [&](size_t p) {
+    size_t count = ((p + 1 < num_pieces) ? cuts[p + 1] : m) - cuts[p];
+    size_t left[_block_size];
+    size_t right[_block_size];
+    for (size_t i = starts[p].first, k = 0; k < count; i++) {
+      left[k] = i;
+      k += misplaced_left(L[i]);
+    }
+    for (size_t j = starts[p].second, k = 0; k < count; j++) {
+      right[k] = j;
+      k += misplaced_right(R[j]);
+    }
+    for (size_t k = 0; k < count; k++) {
+      using std::swap;
+      swap(L[left[k]], R[right[k]]);
+    }
+  }, 1);
+  return t;
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_PARTITION_H_
@@ -0,0 +1,52 @@
+
+#ifndef PARLAY_INTERNAL_POSIX_FILE_ALLOCATOR_IMPL_POSIX
+#define PARLAY_INTERNAL_POSIX_FILE_ALLOCATOR_IMPL_POSIX
+
+#include <cassert>
+#include <cstddef>
+
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+namespace parlay {
+namespace internal {
+
+// Map a fresh, sparse file of n bytes in the given directory with MAP_SHARED.
+// The file is unlinked as soon as it is mapped, so the space is reclaimed by
+// the file system once the mapping is released (or the process exits). Dirty
+// pages are written back through the page cache by the kernel, which lets the
+// buffer be larger than the available physical memory.
+inline void* file_backed_allocate(const std::string& directory, size_t n) {
+  std::string path = directory + "/parlay-XXXXXX";
+  int fd = mkstemp(&path[0]);
+  if (fd == -1) throw std::bad_alloc();
+  ::unlink(path.c_str());
+
+  if (::ftruncate(fd, static_cast<off_t>(n)) == -1) {
+    ::close(fd);
+    throw std::bad_alloc();
+  }
+
+  void* p = mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (p == MAP_FAILED) throw std::bad_alloc();
+  return p;
+}
+
+inline void file_backed_deallocate(void* p, size_t n) {
+  [[maybe_unused]] int res = munmap(p, n);
+  assert(res == 0);
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_POSIX_FILE_ALLOCATOR_IMPL_POSIX
@@ -0,0 +1,89 @@
+
+#ifndef PARLAY_INTERNAL_REMOVE_DUPLICATES_H_
+#define PARLAY_INTERNAL_REMOVE_DUPLICATES_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "sequence_ops.h"
+
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// Hash-based removal of duplicates. The indices of the elements are inserted
+// in parallel into an open-addressing table with linear probing, in which each
+// slot holds one plus the index of an element, or zero if it is empty. An
+// element whose probe sequence reaches an equal element does not take a slot,
+// but if its index is smaller, it replaces the index in that slot. Once all
+// insertions finish, each slot holds the index of the first occurrence of its
+// element, which does not depend on the order of the insertions, so packing
+// the elements at those indices gives the distinct elements in the order of
+// their first occurrences. The expected work is O(n), and only the distinct
+// elements are copied.
+
+template <typename Index, typename Slice, typename Hash, typename Equal>
+auto remove_duplicates_with(Slice A, const Hash& hash, const Equal& eq) {
+  size_t n = A.size();
+
+  // A power of two at least twice n keeps the load factor at most one half
+  size_t log_m = log2_up(2 * (std::max)(n, size_t{1}));
+  size_t m = size_t{1} << log_m;
+  size_t mask = m - 1;
+  sequence<std::atomic<Index>> table(m);
+
+  // Fibonacci hashing spreads the bits of weak hash functions, such
+  // as the identity, over the table before taking the top bits
+  auto first_slot = [&](const auto& x) -> size_t {
+    uint64_t h = static_cast<uint64_t>(hash(x)) * UINT64_C(0x9E3779B97F4A7C15);
+    return static_cast<size_t>(h >> (64 - log_m)) & mask;
+  };
+
+  parallel_for(0, n, [&](size_t i) {
+    Index id = static_cast<Index>(i + 1);
+    size_t h = first_slot(A[i]);
+    while (true) {
+      Index c = table[h].load(std::memory_order_acquire);
+      if (c == 0) {
+        if (table[h].compare_exchange_strong(c, id)) return;
+        // Another element took the slot first, so compare with it
+      }
+      if (c != 0 && eq(A[c - 1], A[i])) {
+        // The slot only ever holds indices of elements equal to this
+        // one from now on, so keep lowering it to this index if smaller
+        while (id < c && !table[h].compare_exchange_weak(c, id)) {}
+        return;
+      }
+      if (c != 0) h = (h + 1) & mask;
+    }
+  });
+
+  auto first = sequence<bool>(n, false);
+  parallel_for(0, m, [&](size_t h) {
+    Index c = table[h].load(std::memory_order_relaxed);
+    if (c != 0) first[c - 1] = true;
+  });
+  return internal::pack(A, first);
+}
+
+template <typename Slice, typename Hash, typename Equal>
+auto remove_duplicates(Slice A, const Hash& hash, const Equal& eq) {
+  // Small indices halve the size of the table
+  if (A.size() < (std::numeric_limits<uint32_t>::max)()) {
+    return remove_duplicates_with<uint32_t>(A, hash, eq);
+  }
+  return remove_duplicates_with<size_t>(A, hash, eq);
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_REMOVE_DUPLICATES_H_
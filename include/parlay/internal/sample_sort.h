@@ -13,6 +13,7 @@
 #include <cstring>
 
 #include "bucket_sort.h"
+#include "ips4o.h"
 #include "quicksort.h"
 #include "sequence_ops.h"
 #include "transpose.h"
@@ -64,15 +65,6 @@ void get_bucket_counts(slice<InIterator, InIterator> sA,
   *itC = static_cast<s_size_t>(sA.end() - itA);
 }
 
-template <typename Iterator, typename Compare>
-void seq_sort_inplace(slice<Iterator, Iterator> A, const Compare& less, bool stable) {
-  using value_type = typename slice<Iterator, Iterator>::value_type;
-  if (((sizeof(value_type) > 8) || std::is_pointer<value_type>::value) && !stable)
-    quicksort(A.begin(), A.size(), less);
-  else
-    bucket_sort(A, less, stable);
-}
-
 template <typename assignment_tag, typename InIterator, typename OutIterator, typename Compare>
 void seq_sort_(slice<InIterator, InIterator> In,
                slice<OutIterator, OutIterator> Out,
@@ -277,10 +269,18 @@ auto sample_sort(slice<Iterator, Iterator> A,
   return R;
 }
 
+// Sorts A in place. Elements that can be copied are sorted with the
+// in-place super scalar sample sort (ips4o.h), which only needs a few buffer
+// blocks per bucket and worker of extra memory. Otherwise, the elements are
+// only moved, through a buffer of size n.
 template <class Iterator, typename Compare>
 void sample_sort_inplace(slice<Iterator, Iterator> A,
                          const Compare& less) {
-  if (A.size() < (std::numeric_limits<unsigned int>::max)()) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  if constexpr (std::is_copy_constructible_v<value_type>) {
+    ips4o_sort_inplace(A, less);
+  }
+  else if (A.size() < (std::numeric_limits<unsigned int>::max)()) {
     sample_sort_inplace_<unsigned int>(A, A, less);
   }
   else {
@@ -0,0 +1,202 @@
+
+#ifndef PARLAY_INTERNAL_SEGMENTED_OPS_H_
+#define PARLAY_INTERNAL_SEGMENTED_OPS_H_
+
+#include <cassert>
+#include <cstddef>
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#include "sequence_ops.h"
+
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// Segmented scans and reductions split the input into contiguous segments and
+// scan or reduce each segment independently. The input is processed in blocks
+// of equal size regardless of where the segments begin and end, so the work is
+// balanced no matter how skewed the segment lengths are:
+//
+//   1. Each block computes whether a segment starts within it, and the sum of
+//      its elements after the last segment start (or all of them if none).
+//   2. The block summaries are scanned with a segmented monoid, which gives
+//      each block the sum of its segment up to the start of the block.
+//   3. Each block scans or reduces its elements starting from that sum.
+//
+// Segments are described by a segmentation, which provides a cursor that walks
+// over the elements of one block in order. The cursor for a block starting at
+// s is positioned at the segment of element s-1 (or segment 0 if s = 0), and
+// starts(i) moves it to the segment of element i, returning true if that is a
+// new segment. segment() is the index of the current segment.
+
+// Segments given by a range of flags. Each element i > 0 whose flag is true
+// starts a new segment. The first element always starts a segment.
+template<typename Flags>
+struct flag_segmentation {
+  const Flags& flags;
+  size_t n;
+
+  flag_segmentation(const Flags& flags_, size_t n_) : flags(flags_), n(n_) {
+    assert(static_cast<size_t>(flags.size()) == n);
+  }
+
+  struct cursor {
+    const Flags& flags;
+    size_t seg;
+    bool starts(size_t i) {
+      if (i > 0 && flags[i]) {
+        seg++;
+        return true;
+      }
+      return false;
+    }
+    size_t segment() const { return seg; }
+  };
+
+  // The cursor for the block starting at s, given the number
+  // of segment starts in the elements before s
+  cursor make_cursor(size_t, size_t starts_before) const { return cursor{flags, starts_before}; }
+
+  size_t num_segments(size_t starts) const { return (n == 0) ? 0 : starts + 1; }
+};
+
+// Segments given by a range of m+1 offsets, as in the compressed sparse row
+// format. Segment k consists of the elements offsets[k], ..., offsets[k+1]-1.
+// The first offset must be zero, the last must be n, and segments may be empty.
+template<typename Offsets>
+struct offset_segmentation {
+  const Offsets& offsets;
+  size_t m;
+
+  offset_segmentation(const Offsets& offsets_, size_t n) : offsets(offsets_), m(offsets.size() - 1) {
+    assert(offsets.size() > 0);
+    assert(static_cast<size_t>(offsets[0]) == 0);
+    assert(static_cast<size_t>(offsets[m]) == n);
+    (void)n;
+  }
+
+  struct cursor {
+    const Offsets& offsets;
+    size_t m;
+    size_t seg;
+    bool starts(size_t i) {
+      bool started = false;
+      while (seg + 1 < m && static_cast<size_t>(offsets[seg + 1]) <= i) {
+        seg++;
+        started = true;
+      }
+      return started;
+    }
+    size_t segment() const { return seg; }
+  };
+
+  cursor make_cursor(size_t s, size_t) const {
+    if (s == 0) return cursor{offsets, m, 0};
+    // The last segment whose first element is at most s-1
+    auto first = std::begin(offsets);
+    auto it = std::upper_bound(first, first + m, s - 1,
+      [](size_t a, const auto& b) { return a < static_cast<size_t>(b); });
+    return cursor{offsets, m, static_cast<size_t>(it - first) - 1};
+  }
+
+  size_t num_segments(size_t) const { return m; }
+};
+
+// Phases 1 and 2 above. Returns, for each block, the number of segment starts
+// before the block and the sum of the segment of the block's first element up
+// to the start of the block, and the total number of segment starts.
+template <typename Seq, typename Segmentation, typename Monoid>
+auto segmented_block_prefixes(const Seq& A, const Segmentation& seg, const Monoid& m) {
+  using T = typename Seq::value_type;
+  using summary = std::pair<bool, T>;
+  size_t n = A.size();
+  size_t l = num_blocks(n, _block_size);
+  auto summaries = sequence<summary>::uninitialized(l);
+  auto counts = sequence<size_t>::uninitialized(l);
+  sliced_for(n, _block_size, [&](size_t b, size_t s, size_t e) {
+    auto c = seg.make_cursor(s, 0);
+    bool reset = false;
+    size_t count = 0;
+    T r = m.identity;
+    for (size_t i = s; i < e; i++) {
+      if (c.starts(i)) {
+        reset = true;
+        r = m.identity;
+        count++;
+      }
+      combine_into(m, r, A[i]);
+    }
+    assign_uninitialized(summaries[b], summary(reset, std::move(r)));
+    assign_uninitialized(counts[b], count);
+  });
+  // A block whose summary resets discards the sum of the blocks before it
+  auto segmented_monoid = make_monoid([&](const summary& a, const summary& b) {
+    return b.first ? b : summary(a.first, m.f(a.second, b.second));
+  }, summary(false, m.identity));
+  scan_inplace(make_slice(summaries), segmented_monoid);
+  size_t total_starts = scan_inplace(make_slice(counts), addm<size_t>());
+  return std::make_tuple(std::move(summaries), std::move(counts), total_starts);
+}
+
+template <typename Seq, typename Segmentation, typename Monoid>
+auto segmented_scan(const Seq& A, const Segmentation& seg, const Monoid& m, flags fl = no_flag) {
+  using T = typename Seq::value_type;
+  size_t n = A.size();
+  bool inclusive = fl & fl_scan_inclusive;
+  auto [prefixes, counts, total_starts] = segmented_block_prefixes(A, seg, m);
+  (void)total_starts;
+  auto Out = sequence<T>::uninitialized(n);
+  sliced_for(n, _block_size, [&](size_t b, size_t s, size_t e) {
+    auto c = seg.make_cursor(s, counts[b]);
+    T r = prefixes[b].second;
+    for (size_t i = s; i < e; i++) {
+      if (c.starts(i)) r = m.identity;
+      if (inclusive) {
+        combine_into(m, r, A[i]);
+        assign_uninitialized(Out[i], r);
+      } else {
+        assign_uninitialized(Out[i], r);
+        combine_into(m, r, A[i]);
+      }
+    }
+  });
+  return Out;
+}
+
+template <typename Seq, typename Segmentation, typename Monoid>
+auto segmented_reduce(const Seq& A, const Segmentation& seg, const Monoid& m) {
+  using T = typename Seq::value_type;
+  size_t n = A.size();
+  auto [prefixes, counts, total_starts] = segmented_block_prefixes(A, seg, m);
+  auto Out = sequence<T>(seg.num_segments(total_starts), m.identity);
+  // The sum of each segment is written by the block that contains its last
+  // element, when it reaches the start of the next segment or the end of
+  // the input. Empty segments are never reached and keep the identity.
+  sliced_for(n, _block_size, [&](size_t b, size_t s, size_t e) {
+    auto c = seg.make_cursor(s, counts[b]);
+    T r = prefixes[b].second;
+    for (size_t i = s; i < e; i++) {
+      size_t prev = c.segment();
+      if (c.starts(i)) {
+        Out[prev] = std::move(r);
+        r = m.identity;
+      }
+      combine_into(m, r, A[i]);
+    }
+    if (e == n) Out[c.segment()] = std::move(r);
+  });
+  return Out;
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_SEGMENTED_OPS_H_
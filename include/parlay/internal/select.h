@@ -0,0 +1,199 @@
+
+#ifndef PARLAY_INTERNAL_SELECT_H_
+#define PARLAY_INTERNAL_SELECT_H_
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "quicksort.h"
+#include "sample_sort.h"
+#include "sequence_ops.h"
+
+#include "../delayed_sequence.h"
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// Parallel selection. The parallel rounds follow Floyd and Rivest: sample
+// roughly n^(2/3) elements, sort the sample, and pick two pivots from it
+// whose ranks bracket the rank of the k'th smallest element in the sample.
+// With high probability, the k'th element lies between the pivots and
+// only O(n^(2/3)) elements do, so after one partition of the input the
+// problem is small enough that the remaining rounds cost little. Small
+// inputs are finished with a sequential quickselect based on split3.
+
+constexpr const size_t _select_base = 1 << 14;
+
+// Sequential quickselect. Rearranges A[0], ..., A[n-1] such that A[k] is
+// the element that would be there if A were sorted, every element before it
+// is not greater, and every element after it is not less.
+template <class Iterator, class BinPred>
+void quickselect_serial(Iterator A, size_t n, size_t k, const BinPred& f) {
+  assert(k < n);
+  while (!base_case(A, n)) {
+    auto [L, M, mid_eq] = split3(A, n, f);
+    size_t l = L - A;
+    size_t m = M - A;
+    if (k < l) {
+      n = l;
+    } else if (k == l || (k < m && mid_eq)) {
+      return;
+    } else if (k < m) {
+      A = L + 1;
+      k -= l + 1;
+      n = m - l - 1;
+    } else {
+      A = M;
+      k -= m;
+      n -= m;
+    }
+  }
+  insertion_sort(A, n, f);
+}
+
+// Moves the elements of A into three consecutive parts: those less than
+// *lo, those between *lo and *hi inclusive, and those greater than *hi. A
+// null pivot does not bound the middle part on that side. The pivots must
+// point to elements of A. Returns the sizes of the first two parts.
+template <typename Iterator, typename T, typename Compare>
+std::pair<size_t, size_t> select_partition(slice<Iterator, Iterator> A, const T* lo,
+                                           const T* hi, const Compare& less) {
+  size_t n = A.size();
+  auto Fl = sequence<unsigned char>::from_function(n, [&](size_t i) -> unsigned char {
+    return (lo != nullptr && less(A[i], *lo)) ? 0 : (hi != nullptr && less(*hi, A[i])) ? 2 : 1;
+  });
+  size_t l = num_blocks(n, _block_size);
+  sequence<size_t> Sums0(l);
+  sequence<size_t> Sums1(l);
+  sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
+    size_t c0 = 0;
+    size_t c1 = 0;
+    for (size_t j = s; j < e; j++) {
+      c0 += (Fl[j] == 0);
+      c1 += (Fl[j] == 1);
+    }
+    Sums0[i] = c0;
+    Sums1[i] = c1;
+  });
+  size_t m0 = scan_inplace(make_slice(Sums0), addm<size_t>());
+  size_t m1 = scan_inplace(make_slice(Sums1), addm<size_t>());
+  auto Tmp = sequence<T>::uninitialized(n);
+  sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
+    size_t c0 = Sums0[i];
+    size_t c1 = m0 + Sums1[i];
+    size_t c2 = m0 + m1 + (s - Sums0[i] - Sums1[i]);
+    for (size_t j = s; j < e; j++) {
+      size_t& c = (Fl[j] == 0) ? c0 : (Fl[j] == 1) ? c1 : c2;
+      assign_uninitialized(Tmp[c++], std::move(A[j]));
+    }
+  });
+  parallel_for(0, n, [&](size_t i) { A[i] = std::move(Tmp[i]); });
+  return std::make_pair(m0, m1);
+}
+
+// Rearranges A such that A[k] is the element that would be there if A were
+// sorted with respect to less, every element before it is not greater, and
+// every element after it is not less. Does not copy any elements, so it also
+// works for types that can only be moved.
+template <typename Iterator, typename Compare>
+void nth_element(slice<Iterator, Iterator> A, size_t k, const Compare& less) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  size_t n = A.size();
+  if (k >= n) return;
+  size_t round = 0;
+  while (n > _select_base) {
+    // Sample indices of A, sorted by the elements they refer to
+    size_t num_samples = (std::max)(size_t{1024}, static_cast<size_t>(std::pow(n, 2.0 / 3.0)));
+    auto samples = sequence<size_t>::from_function(num_samples, [&](size_t i) -> size_t {
+      return hash64(i + round * num_samples) % n; });
+    auto less_index = [&](size_t i, size_t j) { return less(A[i], A[j]); };
+    quicksort(samples.begin(), num_samples, less_index);
+
+    // The rank of the k'th element in the sample is k * num_samples / n,
+    // within a few standard deviations, i.e. multiples of sqrt(num_samples)
+    size_t delta = 2 * static_cast<size_t>(std::sqrt(num_samples));
+    size_t r = static_cast<size_t>(static_cast<double>(k) / n * num_samples);
+    const value_type* lo = (r >= delta) ? &A[samples[r - delta]] : nullptr;
+    const value_type* hi = (r + delta < num_samples) ? &A[samples[r + delta]] : nullptr;
+    bool pivots_equal = lo != nullptr && hi != nullptr && !less(*lo, *hi);
+    auto [m0, m1] = select_partition(A, lo, hi, less);
+
+    // If the pivots failed to split off anything, which can happen when
+    // there are many equal elements, partition around a single pivot
+    // instead. The middle part then contains only elements equal to it.
+    if (m1 == n) {
+      lo = hi = &A[samples[(std::min)(r, num_samples - 1)]];
+      pivots_equal = true;
+      std::tie(m0, m1) = select_partition(A, lo, hi, less);
+    }
+
+    if (k < m0) {
+      A = A.cut(0, m0);
+    } else if (k < m0 + m1) {
+      if (pivots_equal) return;
+      A = A.cut(m0, m0 + m1);
+      k -= m0;
+    } else {
+      A = A.cut(m0 + m1, n);
+      k -= m0 + m1;
+    }
+    n = A.size();
+    round++;
+  }
+  quickselect_serial(A.begin(), n, k, less);
+}
+
+// Rearranges A such that its first k elements are the k smallest with
+// respect to less, in sorted order. The order of the rest is unspecified.
+template <typename Iterator, typename Compare>
+void partial_sort(slice<Iterator, Iterator> A, size_t k, const Compare& less) {
+  size_t n = A.size();
+  k = (std::min)(k, n);
+  if (k == 0) return;
+  if (k < n) nth_element(A, k - 1, less);
+  sample_sort_inplace(A.cut(0, k), less);
+}
+
+// Returns the first k elements of A in sorted order with respect to less,
+// i.e., the same as the first k elements of sample_sort(A, less), without
+// modifying or copying all of A. A pivot chosen from a sample is used to
+// filter out the elements that can not be among the first k.
+template <typename Iterator, typename Compare>
+auto top_k(slice<Iterator, Iterator> A, size_t k, const Compare& less) {
+  using value_type = typename slice<Iterator, Iterator>::value_type;
+  size_t n = A.size();
+  k = (std::min)(k, n);
+  sequence<value_type> candidates;
+  if (n > _select_base && k < n / 4) {
+    size_t num_samples = (std::max)(size_t{1024}, static_cast<size_t>(std::pow(n, 2.0 / 3.0)));
+    auto samples = sequence<size_t>::from_function(num_samples, [&](size_t i) -> size_t {
+      return hash64(i) % n; });
+    auto less_index = [&](size_t i, size_t j) { return less(A[i], A[j]); };
+    quicksort(samples.begin(), num_samples, less_index);
+    size_t delta = 2 * static_cast<size_t>(std::sqrt(num_samples));
+    size_t r = (std::min)(num_samples - 1, k * num_samples / n + delta);
+    const value_type& pivot = A[samples[r]];
+    candidates = internal::filter(A, [&](const value_type& x) { return !less(pivot, x); });
+  }
+  // Unlikely, unless the sample was unlucky
+  if (candidates.size() < k) {
+    candidates = sequence<value_type>(A.begin(), A.end());
+  }
+  partial_sort(make_slice(candidates), k, less);
+  return sequence<value_type>(std::make_move_iterator(candidates.begin()),
+                              std::make_move_iterator(candidates.begin() + k));
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_SELECT_H_
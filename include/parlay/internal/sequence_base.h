@@ -47,6 +47,13 @@ struct sequence_base {
 
   using value_type = T;
 
+  // Elements of long sequences are aligned to the alignment advertised by the
+  // allocator (e.g., a cache line for parlay::aligned_allocator) if it is
+  // larger than the alignment of T. Short sequences are stored inline and are
+  // only aligned to alignof(T).
+  constexpr static size_t buffer_alignment =
+    (allocator_alignment_v<Allocator> > alignof(T)) ? allocator_alignment_v<Allocator> : alignof(T);
+
   // For trivial types, we want to specify a loop granularity so that (a) time isn't wasted
   // by the automatic granularity control on very small sequences, and (b) to give the optimizer
   // a higher chance to combine adjacent loop iterations (e.g. by converting copies in a loop
@@ -118,10 +125,7 @@ struct sequence_base {
       } else {
         auto n = other.size();
         initialize_capacity(n);
-        auto buffer = data();
-        auto other_buffer = other.data();
-        parallel_for(
-            0, n, [&](size_t i) { initialize_explicit(buffer + i, other_buffer[i]); }, copy_granularity(n));
+        initialize_copies(data(), other.data(), n);
         set_size(n);
       }
     }
@@ -237,11 +241,13 @@ struct sequence_base {
       // the data. This prevents alignment issues where the data might get too
       // close to the capacity. With this member, we can use offsetof to compute
       // its position, at which we then allocate space for capacity elements
-      // of type value_type.
+      // of type value_type. If the allocator advertises a larger alignment,
+      // data is aligned to that instead (this wastes some bytes between the
+      // capacity and the elements, but makes data() aligned).
       struct header {
         const size_t capacity;
         union {
-          alignas(value_type) std::byte data[1];
+          alignas(buffer_alignment) std::byte data[1];
         };
 
         static header* create(size_t capacity, raw_allocator_type& a) {
@@ -259,8 +265,19 @@ struct sequence_base {
         explicit header(size_t _capacity) : capacity(_capacity) {}
         ~header() = delete;
 
-        value_type* get_data() { return reinterpret_cast<value_type*>(std::addressof(data)); }
-        const value_type* get_data() const { return reinterpret_cast<const value_type*>(std::addressof(data)); }
+        value_type* get_data() { return assume_aligned(reinterpret_cast<value_type*>(std::addressof(data))); }
+        const value_type* get_data() const { return assume_aligned(reinterpret_cast<const value_type*>(std::addressof(data))); }
+
+        // Let the compiler know about the buffer alignment so that loops over the
+        // elements can be vectorized with aligned loads and stores
+        template<typename P>
+        static P* assume_aligned(P* p) {
+#if defined(__GNUC__)
+          return static_cast<P*>(__builtin_assume_aligned(p, buffer_alignment));
+#else
+          return p;
+#endif
+        }
       };
 
       // Construct a capacitated buffer with the capacity to hold the given
@@ -469,6 +486,23 @@ struct sequence_base {
       std::allocator_traits<T_allocator_type>::construct(*this, p, std::move(v));
     }
 
+    // Copy initialize the n objects starting at the uninitialized memory
+    // location p from the range starting at first, in parallel. Trivially
+    // copyable objects in contiguous memory are copied by memcpy.
+    template<typename Iterator>
+    void initialize_copies(value_type* p, Iterator first, size_t n) {
+      if constexpr (is_contiguous_iterator_v<Iterator> &&
+                    std::is_same_v<typename std::iterator_traits<Iterator>::value_type, value_type> &&
+                    std::is_trivially_copyable_v<value_type> &&
+                    is_trivial_allocator_v<T_allocator_type, value_type>) {
+        parallel_copy_n<true>(p, first, n);
+      }
+      else {
+        parallel_for(
+            0, n, [&](size_t i) { initialize_explicit(p + i, first[i]); }, copy_granularity(n));
+      }
+    }
+
     // Destroy the object of type value_type pointed to by p
     void destroy(value_type* p) { std::allocator_traits<T_allocator_type>::destroy(*this, p); }
 
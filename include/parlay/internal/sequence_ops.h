@@ -2,7 +2,10 @@
 #ifndef PARLAY_SEQUENCE_OPS_H_
 #define PARLAY_SEQUENCE_OPS_H_
 
+#include <atomic>
 #include <iostream>
+#include <thread>
+#include <tuple>
 
 #include "../delayed_sequence.h"
 #include "../monoid.h"
@@ -10,6 +13,9 @@
 #include "../sequence.h"
 #include "../utilities.h"
 
+#include "simd_kernels.h"
+#include "uninitialized_sequence.h"
+
 namespace parlay {
 namespace internal {
 
@@ -100,8 +106,13 @@ void sliced_for(size_t n, size_t block_size, const F &f, flags fl = no_flag) {
 template <typename Seq, typename Monoid>
 auto reduce_serial(Seq const &A, Monoid m) -> typename Seq::value_type {
   using T = typename Seq::value_type;
+#ifdef PARLAY_SIMD_KERNELS
+  if constexpr (is_contiguous_iterator_v<decltype(A.begin())> && use_simd_kernel_v<Monoid, T>) {
+    return simd_reduce<Monoid>(&*A.begin(), A.size(), m.identity);
+  }
+#endif
   T r = A[0];
-  for (size_t j = 1; j < A.size(); j++) r = m.f(r, A[j]);
+  for (size_t j = 1; j < A.size(); j++) combine_into(m, r, A[j]);
   return r;
 }
 
@@ -120,6 +131,14 @@ auto reduce(Seq const &A, Monoid m, flags fl = no_flag) ->
   sliced_for(n, block_size, [&](size_t i, size_t s, size_t e) {
     Sums[i] = reduce_serial(make_slice(A).cut(s, e), m);
   });
+  if constexpr (!std::is_trivially_copyable_v<T>) {
+    // The block sums are not needed afterwards, so they can be moved
+    if (l <= block_size) {
+      T r = std::move(Sums[0]);
+      for (size_t i = 1; i < l; i++) combine_into(m, r, std::move(Sums[i]));
+      return r;
+    }
+  }
   T r = internal::reduce(Sums, m);
   return r;
 }
@@ -134,26 +153,129 @@ auto scan_serial(In_Seq const &In, Out_Seq Out, Monoid const &m,
   T r = offset;
   size_t n = In.size();
   bool inclusive = fl & fl_scan_inclusive;
+#ifdef PARLAY_SIMD_KERNELS
+  using Out_It = decltype(Out.begin());
+  if constexpr (is_contiguous_iterator_v<decltype(In.begin())> && is_contiguous_iterator_v<Out_It> &&
+                std::is_same_v<std::remove_pointer_t<Out_It>, T> && use_simd_kernel_v<Monoid, T>) {
+    if (n == 0) return r;
+    return simd_scan<Monoid>(&*In.begin(), &*Out.begin(), n, offset, m.identity, inclusive);
+  }
+#endif
   if (inclusive) {
     for (size_t i = 0; i < n; i++) {
-      r = m.f(r, In[i]);
+      combine_into(m, r, In[i]);
       if (out_uninitialized)
 	assign_uninitialized(Out[i], r);
       else Out[i] = r;
     }
+  } else if (out_uninitialized) {
+    // The output is separate from the input, so In[i] can be read after
+    // Out[i] is written without copying it first
+    for (size_t i = 0; i < n; i++) {
+      assign_uninitialized(Out[i], r);
+      combine_into(m, r, In[i]);
+    }
   } else {
     for (size_t i = 0; i < n; i++) {
       T t = In[i];
-      if (out_uninitialized)
-	assign_uninitialized(Out[i], r);
-      else Out[i] = r;
-      r = m.f(r, t);
+      Out[i] = r;
+      combine_into(m, r, std::move(t));
     }
   }
   return r;
 }
 
   
+// True if scan_ can use the single-pass look-back scan, which is only safe
+// when reading the input and combining elements can not fork. A worker that
+// reaches a join while it holds a block may run a stolen task that claims a
+// later block, which would then wait forever on the block suspended under it.
+// This holds for contiguous arrays of arithmetic types with the vectorizable
+// monoids, which are also the cases where one pass saves the most.
+template <typename In_Seq, typename Out_Range, class Monoid>
+inline constexpr bool use_look_back_scan_v =
+    is_contiguous_iterator_v<decltype(std::declval<const In_Seq&>().begin())> &&
+    is_contiguous_iterator_v<decltype(std::declval<Out_Range&>().begin())> &&
+    std::is_same_v<typename Out_Range::value_type, typename In_Seq::value_type> &&
+    use_simd_kernel_v<Monoid, typename In_Seq::value_type>;
+
+// Single-pass scan with decoupled look-back. Blocks are claimed in increasing
+// order from a shared counter by a fixed number of tasks. Each block reduces
+// its elements, obtains the prefix of all blocks before it from its
+// predecessors, publishes its own inclusive prefix, and then scans its elements
+// into the output while they are still in cache. The input is therefore read
+// from memory only once, instead of once for the block sums and once more for
+// the final pass.
+//
+// Since blocks are claimed in order, and a block is processed without
+// forking, a block only ever waits on blocks that are being processed by
+// tasks that are running on other workers. Other scans use two passes.
+//
+// For integral types, a block also publishes its aggregate before it looks
+// back, so that a successor can combine the aggregates of several pending
+// blocks instead of waiting for each prefix in turn. Other types (e.g.,
+// floating point) only use the predecessor's inclusive prefix, so that the
+// result is combined in the same order on every run.
+template <typename In_Seq, typename Out_Range, class Monoid>
+auto scan_look_back_(In_Seq const &In, Out_Range Out, Monoid const &m, flags fl,
+                     bool out_uninitialized)
+    -> typename In_Seq::value_type {
+  using T = typename In_Seq::value_type;
+  size_t n = In.size();
+  size_t l = num_blocks(n, _block_size);
+  constexpr bool use_aggregates = std::is_integral_v<T>;
+  enum : int { not_ready = 0, aggregate_ready = 1, prefix_ready = 2 };
+  sequence<std::atomic<int>> status(l);
+  sequence<T> aggregates(use_aggregates ? l : 0);
+  sequence<T> prefixes(l);
+  std::atomic<size_t> next_block(0);
+
+  auto wait_while_not_ready = [&](size_t j) {
+    int st;
+    for (size_t tries = 0; (st = status[j].load(std::memory_order_acquire)) == not_ready; tries++) {
+      if (tries >= 1000) std::this_thread::yield();
+    }
+    return st;
+  };
+
+  // The combination of all blocks before block i
+  auto look_back = [&](size_t i) -> T {
+    if constexpr (use_aggregates) {
+      T acc = m.identity;
+      for (size_t j = i - 1; ; j--) {
+        if (wait_while_not_ready(j) == prefix_ready) return m.f(prefixes[j], acc);
+        acc = m.f(aggregates[j], acc);
+      }
+    }
+    else {
+      while (wait_while_not_ready(i - 1) != prefix_ready) {}
+      return prefixes[i - 1];
+    }
+  };
+
+  size_t num_tasks = (std::min)(l, num_workers());
+  parallel_for(0, num_tasks, [&](size_t) {
+    size_t i;
+    while ((i = next_block.fetch_add(1, std::memory_order_relaxed)) < l) {
+      size_t s = i * _block_size;
+      size_t e = (std::min)(s + _block_size, n);
+      auto block = make_slice(In).cut(s, e);
+      T sum = reduce_serial(block, m);
+      if constexpr (use_aggregates) {
+        if (i > 0) {
+          aggregates[i] = sum;
+          status[i].store(aggregate_ready, std::memory_order_release);
+        }
+      }
+      T offset = (i == 0) ? T(m.identity) : look_back(i);
+      prefixes[i] = m.f(offset, sum);
+      status[i].store(prefix_ready, std::memory_order_release);
+      scan_serial(block, make_slice(Out).cut(s, e), m, offset, fl, out_uninitialized);
+    }
+  }, 1, 0 != (fl & fl_conservative));
+  return prefixes[l - 1];
+}
+
 template <typename In_Seq, typename Out_Range, class Monoid>
 auto scan_(In_Seq const &In, Out_Range Out, Monoid const &m, flags fl,
 	   bool out_uninitialized=false)
@@ -163,6 +285,8 @@ auto scan_(In_Seq const &In, Out_Range Out, Monoid const &m, flags fl,
   size_t l = num_blocks(n, _block_size);
   if (l <= 2 || fl & fl_sequential)
     return scan_serial(In, Out, m, m.identity, fl, out_uninitialized);
+  if constexpr (use_look_back_scan_v<In_Seq, Out_Range, Monoid>)
+    return scan_look_back_(In, Out, m, fl, out_uninitialized);
   sequence<T> Sums(l);
   sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
     Sums[i] = reduce_serial(make_slice(In).cut(s, e), m);
@@ -219,8 +343,25 @@ auto pack_serial(In_Seq const &In, Bool_Seq const &Fl)
 }
 
 
+// True if packing the slice In by the flags Fl into the slice Out can
+// use the vectorized compress kernel, i.e., if the flags are an array of
+// bools, and In and Out are arrays of the same 4- or 8-byte type
+template <typename In_Slice, typename Fl_Slice, typename Out_Slice>
+inline constexpr bool use_compress_kernel_v =
+    is_contiguous_iterator_v<decltype(std::declval<In_Slice>().begin())> &&
+    is_contiguous_iterator_v<decltype(std::declval<Fl_Slice>().begin())> &&
+    is_contiguous_iterator_v<decltype(std::declval<Out_Slice>().begin())> &&
+    std::is_same_v<typename Fl_Slice::value_type, bool> &&
+    std::is_same_v<typename In_Slice::value_type, typename Out_Slice::value_type> &&
+    use_simd_compress_v<typename In_Slice::value_type>;
+
 template <class Slice, class Slice2, typename Out_Seq>
 size_t pack_serial_at(Slice In, Slice2 Fl, Out_Seq Out) {
+#ifdef PARLAY_SIMD_KERNELS
+  if constexpr (use_compress_kernel_v<Slice, Slice2, Out_Seq>) {
+    return simd_compress(In.begin(), Fl.begin(), In.size(), Out.begin(), Out.size());
+  }
+#endif
   size_t k = 0;
   for (size_t i = 0; i < In.size(); i++)
     if (Fl[i]) assign_uninitialized(Out[k++], In[i]);
@@ -254,7 +395,9 @@ size_t pack_out(In_Seq const &In, Bool_Seq const &Fl, Out_Seq Out,
   size_t n = In.size();
   size_t l = num_blocks(n, _block_size);
   if (l <= 1 || fl & fl_sequential) {
-    return pack_serial_at(In, make_slice(Fl).cut(0, In.size()), Out);
+    // The compress kernel needs an exactly sized output
+    size_t m = sum_bools_serial(make_slice(Fl).cut(0, n));
+    return pack_serial_at(In, make_slice(Fl).cut(0, n), make_slice(Out).cut(0, m));
   }
   sequence<size_t> Sums(l);
   sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
@@ -268,36 +411,96 @@ size_t pack_out(In_Seq const &In, Bool_Seq const &Fl, Out_Seq Out,
   return m;
 }
 
-// like filter but applies g before returning result
-template <typename In_Seq, typename F, typename G>
-auto filter_map(In_Seq const &In, F f, G g) {
-  using outT = decltype(g(In[0]));
+// The index of the lowest set bit of a nonzero word
+inline size_t lowest_bit(uint64_t x) {
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_ctzll(x));
+#else
+  size_t k = 0;
+  while (!(x & 1)) { x >>= 1; k++; }
+  return k;
+#endif
+}
+
+// The number of set bits of a word
+inline size_t count_bits(uint64_t x) {
+#if defined(__GNUC__)
+  return static_cast<size_t>(__builtin_popcountll(x));
+#else
+  size_t k = 0;
+  for (; x != 0; x &= x - 1) k++;
+  return k;
+#endif
+}
+
+// Applies f to each element of In once, and records which elements pass
+// in a bit mask with one bit per element, the j'th element in bit j % 64
+// of word j / 64. Returns the mask, the offset of each block in the packed
+// output, and the total number of elements that passed. A block is a whole
+// number of words, so each word is written by one block.
+template <typename In_Seq, typename F>
+auto filter_bits(In_Seq const &In, F& f) {
+  static_assert(_block_size % 64 == 0);
   size_t n = In.size();
   size_t l = num_blocks(n, _block_size);
-  auto in_mapped = delayed_seq<outT>(n, [&] (size_t i) {return g(In[i]);});
-
+  auto Bits = sequence<uint64_t>::uninitialized((n + 63) / 64);
   sequence<size_t> Sums(l);
-  sequence<bool> Fl(n);
   sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
     size_t r = 0;
-    for (size_t j = s; j < e; j++) r += (Fl[j] = f(In[j]));
+    for (size_t w = s / 64; w * 64 < e; w++) {
+      uint64_t word = 0;
+      size_t we = (std::min)(w * 64 + 64, e);
+      for (size_t j = w * 64; j < we; j++) {
+        word |= static_cast<uint64_t>(static_cast<bool>(f(In[j]))) << (j % 64);
+      }
+      Bits[w] = word;
+      r += count_bits(word);
+    }
     Sums[i] = r;
   });
   size_t m = scan_inplace(make_slice(Sums), addm<size_t>());
-  sequence<outT> Out = sequence<outT>::uninitialized(m);
-  sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
-    pack_serial_at(make_slice(in_mapped).cut(s, e),
-		   make_slice(Fl).cut(s, e),
-                   make_slice(Out).cut(Sums[i], (i == l - 1) ? m : Sums[i + 1]));
+  return std::make_tuple(std::move(Bits), std::move(Sums), m);
+}
+
+// Writes g of each element of In whose bit is set straight to its final
+// position in Out, which is uninitialized. Only those elements are read.
+template <typename In_Seq, typename G, typename Out_Seq>
+void write_filter_bits(In_Seq const &In, G& g, const sequence<uint64_t>& Bits,
+                       const sequence<size_t>& Sums, Out_Seq Out) {
+  sliced_for(In.size(), _block_size, [&](size_t i, size_t s, size_t e) {
+    size_t k = Sums[i];
+    for (size_t w = s / 64; w * 64 < e; w++) {
+      for (uint64_t word = Bits[w]; word != 0; word &= word - 1) {
+        assign_uninitialized(Out[k++], g(In[w * 64 + lowest_bit(word)]));
+      }
+    }
   });
+}
+
+// Filters in two passes without a flag per element or a copy of the kept
+// elements. The first pass evaluates f once per element and keeps one bit
+// per element, n/8 bytes in all, and the second reads only the elements
+// that are kept and writes them once, to their final positions.
+template <typename In_Seq, typename F, typename G>
+auto filter_map_impl(In_Seq const &In, F& f, G& g) {
+  using outT = decltype(g(In[0]));
+  auto [Bits, Sums, m] = filter_bits(In, f);
+  auto Out = sequence<outT>::uninitialized(m);
+  write_filter_bits(In, g, Bits, Sums, Out.begin());
   return Out;
 }
 
+// like filter but applies g before returning result
+template <typename In_Seq, typename F, typename G>
+auto filter_map(In_Seq const &In, F f, G g) {
+  return filter_map_impl(In, f, g);
+}
+
 template <typename In_Seq, typename F>
 auto filter(In_Seq const &In, F f) -> sequence<typename In_Seq::value_type> {
   using T = typename In_Seq::value_type;
   auto identity = [&] (T x) -> T {return x;}; // no longer needed in c++20
-  return filter_map(In, f, identity);
+  return filter_map_impl(In, f, identity);
 }
 
 template <typename In_Seq, typename F>
@@ -308,20 +511,10 @@ auto filter(In_Seq const &In, F f, flags) {
 // Filter and write the output to the output range.
 template <typename In_Seq, typename Out_Seq, typename F>
 size_t filter_out(In_Seq const &In, Out_Seq Out, F f) {
-  size_t n = In.size();
-  size_t l = num_blocks(n, _block_size);
-  sequence<size_t> Sums(l);
-  sequence<bool> Fl(n);
-  sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
-    size_t r = 0;
-    for (size_t j = s; j < e; j++) r += (Fl[j] = f(In[j]));
-    Sums[i] = r;
-  });
-  size_t m = scan_inplace(make_slice(Sums), addm<size_t>());
-  sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
-    pack_serial_at(make_slice(In).cut(s, e), make_slice(Fl).cut(s, e),
-                   make_slice(Out).cut(Sums[i], (i == l - 1) ? m : Sums[i + 1]));
-  });
+  using T = typename In_Seq::value_type;
+  auto identity = [&] (const T& x) -> const T& {return x;};
+  auto [Bits, Sums, m] = filter_bits(In, f);
+  write_filter_bits(In, identity, Bits, Sums, Out.begin());
   return m;
 }
 
@@ -330,8 +523,102 @@ size_t filter_out(In_Seq const &In, Out_Seq Out, F f, flags) {
   return filter_out(In, Out, f);
 }
 
+// Unordered filters and packs make one pass over the input and do not
+// scan. Each block evaluates the predicate on its elements, keeping the
+// results on the stack, then reserves the range of the output that its
+// elements go to with one fetch_add on a shared counter, and writes them
+// while they are still in cache. The elements of each block stay in order,
+// but the blocks appear in the output in the order that they finish.
+
+template <typename In_Seq, typename Out_Seq, typename F>
+size_t filter_unordered_out(In_Seq const &In, Out_Seq Out, F&& f) {
+  std::atomic<size_t> count(0);
+  sliced_for(In.size(), _block_size, [&](size_t, size_t s, size_t e) {
+    bool keep[_block_size];
+    size_t r = 0;
+    for (size_t j = s; j < e; j++) r += (keep[j - s] = f(In[j]));
+    if (r == 0) return;
+    size_t k = count.fetch_add(r, std::memory_order_relaxed);
+    for (size_t j = s; j < e; j++) {
+      if (keep[j - s]) assign_uninitialized(Out[k++], In[j]);
+    }
+  });
+  return count.load();
+}
+
+template <typename In_Seq, typename Bool_Seq, typename Out_Seq>
+size_t pack_unordered_out(In_Seq const &In, Bool_Seq const &Fl, Out_Seq Out) {
+  std::atomic<size_t> count(0);
+  sliced_for(In.size(), _block_size, [&](size_t, size_t s, size_t e) {
+    size_t r = sum_bools_serial(make_slice(Fl).cut(s, e));
+    if (r == 0) return;
+    size_t k = count.fetch_add(r, std::memory_order_relaxed);
+    for (size_t j = s; j < e; j++) {
+      if (Fl[j]) assign_uninitialized(Out[k++], In[j]);
+    }
+  });
+  return count.load();
+}
+
+// Runs write, which writes at most n elements of type T to the given
+// uninitialized output and returns how many, and returns them as a sequence
+template <typename T, typename Write>
+sequence<T> collect_unordered(size_t n, Write&& write) {
+  if constexpr (std::is_trivially_destructible_v<T>) {
+    auto Out = sequence<T>::uninitialized(n);
+    size_t m = write(Out.begin());
+    if (m == 0) return sequence<T>();
+    // Keep the buffer if most of it is used, otherwise copy the output
+    // out of it so that the unused part is freed
+    if (2 * m >= n) {
+      Out.resize(m, Out[0]);
+      return Out;
+    }
+    return sequence<T>(Out.begin(), Out.begin() + m);
+  }
+  else {
+    uninitialized_sequence<T> Tmp(n);
+    size_t m = write(Tmp.begin());
+    auto Out = sequence<T>::uninitialized(m);
+    uninitialized_relocate_n(Out.begin(), Tmp.begin(), m);
+    return Out;
+  }
+}
+
+template <typename In_Seq, typename F>
+auto filter_unordered(In_Seq const &In, F&& f) {
+  using T = typename In_Seq::value_type;
+  return collect_unordered<T>(In.size(), [&](auto Out) { return filter_unordered_out(In, Out, f); });
+}
+
+template <typename In_Seq, typename Bool_Seq>
+auto pack_unordered(In_Seq const &In, Bool_Seq const &Fl) {
+  using T = typename In_Seq::value_type;
+  return collect_unordered<T>(In.size(), [&](auto Out) { return pack_unordered_out(In, Fl, Out); });
+}
+
 template <typename Idx_Type, typename Bool_Seq>
 auto pack_index(Bool_Seq const &Fl, flags fl = no_flag) {
+#ifdef PARLAY_SIMD_KERNELS
+  if constexpr (std::is_integral_v<Idx_Type> && use_simd_compress_v<Idx_Type> &&
+                is_contiguous_iterator_v<decltype(Fl.begin())> &&
+                std::is_same_v<typename Bool_Seq::value_type, bool>) {
+    // The indices are computed a vector at a time by the kernel
+    size_t n = Fl.size();
+    size_t l = num_blocks(n, _block_size);
+    sequence<size_t> Sums(l);
+    sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
+      Sums[i] = sum_bools_serial(make_slice(Fl).cut(s, e));
+    }, fl);
+    size_t m = scan_inplace(make_slice(Sums), addm<size_t>());
+    auto Out = sequence<Idx_Type>::uninitialized(m);
+    sliced_for(n, _block_size, [&](size_t i, size_t s, size_t e) {
+      size_t cap = ((i == l - 1) ? m : Sums[i + 1]) - Sums[i];
+      simd_compress_index(s, Fl.begin() + s, e - s, Out.begin() + Sums[i], cap);
+    }, fl);
+    return Out;
+  }
+#endif
   auto identity = [](size_t i) -> Idx_Type { return static_cast<Idx_Type>(i); };
   return pack(delayed_seq<Idx_Type>(Fl.size(), identity), Fl, fl);
 }
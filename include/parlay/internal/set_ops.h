@@ -0,0 +1,175 @@
+
+#ifndef PARLAY_INTERNAL_SET_OPS_H_
+#define PARLAY_INTERNAL_SET_OPS_H_
+
+#include <cstddef>
+
+#include <algorithm>
+#include <utility>
+
+#include "binary_search.h"
+#include "merge.h"
+#include "sequence_ops.h"
+
+#include "../parallel.h"
+#include "../sequence.h"
+#include "../slice.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// Set operations on sorted sequences, with the same multiset semantics as
+// the corresponding std:: algorithms. For example, if an element appears m
+// times in A and n times in B, it appears max(m,n) times in the union and
+// min(m,n) times in the intersection.
+//
+// The inputs are cut into pieces at split values taken at even strides from
+// one or both inputs, such that all elements equal to a split value fall into
+// the same piece. The pieces are then processed independently, first to count
+// the size of their outputs, and then to write them at their offsets in an
+// output of exactly the right size.
+//
+// Within a piece, runs of elements from one input that are smaller than the
+// next element of the other are found by galloping (exponential search), so
+// when one input is much smaller than the other, the work is proportional to
+// the smaller size times the log of the ratio rather than to the total size.
+
+enum class set_op { set_union, set_intersection, set_difference, set_symmetric_difference };
+
+// Whether an operation outputs the elements of A (respectively B) that have
+// no matching element in the other input
+constexpr bool keeps_unmatched_a(set_op op) {
+  return op == set_op::set_union || op == set_op::set_difference ||
+         op == set_op::set_symmetric_difference;
+}
+
+constexpr bool keeps_unmatched_b(set_op op) {
+  return op == set_op::set_union || op == set_op::set_symmetric_difference;
+}
+
+// Whether an operation outputs one copy of each matched pair of elements
+constexpr bool keeps_matched(set_op op) {
+  return op == set_op::set_union || op == set_op::set_intersection;
+}
+
+// Returns the first index k >= start such that !pred(A[k]), or A.size()
+// if there is none. Short runs are the common case, so the first few
+// elements are checked one at a time before switching to galloping.
+template <typename Seq, typename Pred>
+size_t gallop(const Seq& A, size_t start, const Pred& pred) {
+  size_t n = A.size();
+  size_t linear_end = (std::min)(n, start + 8);
+  for (; start < linear_end; start++) {
+    if (!pred(A[start])) return start;
+  }
+  if (start == n) return n;
+  // Exponential search for a range [lo, hi) that contains the answer
+  size_t lo = start;
+  size_t step = 1;
+  while (lo + step < n && pred(A[lo + step])) {
+    lo += step;
+    step *= 2;
+  }
+  size_t hi = (std::min)(n, lo + step + 1);
+  return lo + binary_search(make_slice(A).cut(lo, hi), pred);
+}
+
+// Computes the operation on A and B sequentially. If Write is true, writes
+// the output to Out, which must be uninitialized. Returns the output size.
+template <set_op op, bool Write, typename SliceA, typename SliceB, typename OutIterator, typename Compare>
+size_t seq_set_op(const SliceA& A, const SliceB& B, OutIterator Out, const Compare& less) {
+  size_t nA = A.size();
+  size_t nB = B.size();
+  size_t i = 0, j = 0, k = 0;
+  auto emit_a = [&](size_t s, size_t e) {
+    if constexpr (Write) {
+      for (size_t x = s; x < e; x++) assign_uninitialized(Out[k + x - s], A[x]);
+    }
+    k += e - s;
+  };
+  auto emit_b = [&](size_t s, size_t e) {
+    if constexpr (Write) {
+      for (size_t x = s; x < e; x++) assign_uninitialized(Out[k + x - s], B[x]);
+    }
+    k += e - s;
+  };
+  while (i < nA && j < nB) {
+    if (less(A[i], B[j])) {
+      size_t e = gallop(A, i + 1, [&](const auto& a) { return less(a, B[j]); });
+      if constexpr (keeps_unmatched_a(op)) emit_a(i, e);
+      i = e;
+    } else if (less(B[j], A[i])) {
+      size_t e = gallop(B, j + 1, [&](const auto& b) { return less(b, A[i]); });
+      if constexpr (keeps_unmatched_b(op)) emit_b(j, e);
+      j = e;
+    } else {
+      if constexpr (keeps_matched(op)) emit_a(i, i + 1);
+      i++;
+      j++;
+    }
+  }
+  if constexpr (keeps_unmatched_a(op)) emit_a(i, nA);
+  if constexpr (keeps_unmatched_b(op)) emit_b(j, nB);
+  return k;
+}
+
+// Returns the positions at which to cut A and B into pieces, including
+// (0,0) and (nA,nB). Every split value v taken from one of the inputs
+// cuts both inputs at their first element not less than v.
+template <typename SliceA, typename SliceB, typename Compare>
+auto set_split_points(const SliceA& A, const SliceB& B, const Compare& less,
+                      bool split_on_a, bool split_on_b) {
+  using split = std::pair<size_t, size_t>;
+  size_t nA = A.size();
+  size_t nB = B.size();
+  size_t stride = _merge_base;
+  size_t pA = split_on_a ? nA / stride : 0;
+  size_t pB = split_on_b ? nB / stride : 0;
+  auto splits_a = sequence<split>::from_function(pA, [&](size_t i) {
+    const auto& v = A[(i + 1) * stride - 1];
+    return split(binary_search(A, v, less), binary_search(B, v, less));
+  });
+  auto splits_b = sequence<split>::from_function(pB, [&](size_t i) {
+    const auto& v = B[(i + 1) * stride - 1];
+    return split(binary_search(A, v, less), binary_search(B, v, less));
+  });
+  // Split points from either input are ordered in both coordinates, so
+  // ordering them lexicographically interleaves them consistently
+  auto splits = merge(make_slice(splits_a), make_slice(splits_b), std::less<split>());
+  size_t m = splits.size();
+  return sequence<split>::from_function(m + 2, [&](size_t i) {
+    return (i == 0) ? split(0, 0) : (i == m + 1) ? split(nA, nB) : splits[i - 1];
+  });
+}
+
+template <set_op op, typename IteratorA, typename IteratorB, typename Compare>
+auto set_operation(slice<IteratorA, IteratorA> A, slice<IteratorB, IteratorB> B, const Compare& less) {
+  using T = typename slice<IteratorA, IteratorA>::value_type;
+  size_t nA = A.size();
+  size_t nB = B.size();
+
+  // Split on the inputs whose elements can be in the output, and for the
+  // intersection, on the smaller one. The other input is galloped over.
+  bool split_on_a = keeps_unmatched_a(op) || (op == set_op::set_intersection && nA <= nB);
+  bool split_on_b = keeps_unmatched_b(op) || (op == set_op::set_intersection && nB < nA);
+  auto points = set_split_points(A, B, less, split_on_a, split_on_b);
+  size_t num_pieces = points.size() - 1;
+  auto piece_a = [&](size_t p) { return A.cut(points[p].first, points[p + 1].first); };
+  auto piece_b = [&](size_t p) { return B.cut(points[p].second, points[p + 1].second); };
+
+  auto offsets = sequence<size_t>::from_function(num_pieces, [&](size_t p) {
+    return seq_set_op<op, false>(piece_a(p), piece_b(p), (T*)nullptr, less);
+  }, 1);
+  size_t total = scan_inplace(make_slice(offsets), addm<size_t>());
+  auto R = sequence<T>::uninitialized(total);
+  parallel_for(0, num_pieces, [&](size_t p) {
+    seq_set_op<op, true>(piece_a(p), piece_b(p), R.begin() + offsets[p], less);
+  }, 1);
+  return R;
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_SET_OPS_H_
@@ -0,0 +1,399 @@
+// Vectorized serial kernels for reducing and scanning contiguous arrays of
+// arithmetic values with the built-in monoids addm, maxm, minm and xorm,
+// and for compacting arrays of 4- and 8-byte values by an array of flags.
+//
+// The kernels are written with the GCC/Clang vector extensions, so the
+// compiler emits whatever vector instructions the target supports (SSE2,
+// AVX2 or AVX-512 on x86, NEON on ARM). The vector width is selected at
+// compile time from the target macros, so compile with -march=native (or
+// an explicit target) to get the widest vectors.
+//
+// The kernels reassociate the monoid operation. For integers, min and max
+// this gives identical results, but floating-point sums may differ in the
+// last bits from a left-to-right loop, just as they do for the parallel
+// blocked algorithms.
+
+#ifndef PARLAY_INTERNAL_SIMD_KERNELS_H_
+#define PARLAY_INTERNAL_SIMD_KERNELS_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <type_traits>
+#include <utility>
+
+#include "../monoid.h"
+
+#if defined(__GNUC__) && !defined(PARLAY_NO_SIMD_KERNELS)
+#define PARLAY_SIMD_KERNELS
+#endif
+
+#if defined(PARLAY_SIMD_KERNELS) && (defined(__AVX2__) || defined(__AVX512F__))
+#include <immintrin.h>
+#endif
+
+namespace parlay {
+namespace internal {
+
+// For each vectorizable monoid, apply performs the monoid operation
+// either on scalars or elementwise on vectors, in the same way as m.f
+template<typename Monoid>
+struct simd_monoid {
+  static constexpr bool value = false;
+};
+
+template<typename TT>
+struct simd_monoid<addm<TT>> {
+  static constexpr bool value = true;
+  using T = TT;
+  template<typename V> static V apply(V a, V b) { return a + b; }
+};
+
+template<typename TT>
+struct simd_monoid<maxm<TT>> {
+  static constexpr bool value = true;
+  using T = TT;
+  template<typename V> static V apply(V a, V b) { return (a < b) ? b : a; }
+};
+
+template<typename TT>
+struct simd_monoid<minm<TT>> {
+  static constexpr bool value = true;
+  using T = TT;
+  template<typename V> static V apply(V a, V b) { return (b < a) ? b : a; }
+};
+
+template<typename TT>
+struct simd_monoid<xorm<TT>> {
+  static constexpr bool value = std::is_integral_v<TT>;
+  using T = TT;
+  template<typename V> static V apply(V a, V b) { return a ^ b; }
+};
+
+template<typename T>
+inline constexpr bool is_simd_value_type_v =
+    (std::is_integral_v<T> || std::is_floating_point_v<T>) &&
+    !std::is_same_v<T, bool> && sizeof(T) <= 8;
+
+// True if reducing or scanning values of type T with Monoid can use the
+// vectorized kernels
+template<typename Monoid, typename T>
+constexpr bool use_simd_kernel() {
+#ifdef PARLAY_SIMD_KERNELS
+  using M = std::remove_cv_t<std::remove_reference_t<Monoid>>;
+  if constexpr (simd_monoid<M>::value) {
+    return is_simd_value_type_v<T> && std::is_same_v<typename simd_monoid<M>::T, T>;
+  }
+#endif
+  return false;
+}
+
+template<typename Monoid, typename T>
+inline constexpr bool use_simd_kernel_v = use_simd_kernel<Monoid, T>();
+
+// True if arrays of T can be compacted with simd_compress. The kernels
+// only copy bits, so any trivially copyable type of 4 or 8 bytes works.
+template<typename T>
+constexpr bool use_simd_compress() {
+#ifdef PARLAY_SIMD_KERNELS
+  return std::is_trivially_copyable_v<T> && (sizeof(T) == 4 || sizeof(T) == 8);
+#else
+  return false;
+#endif
+}
+
+template<typename T>
+inline constexpr bool use_simd_compress_v = use_simd_compress<T>();
+
+#ifdef PARLAY_SIMD_KERNELS
+
+#if defined(__AVX512F__)
+constexpr const size_t _simd_bytes = 64;
+#elif defined(__AVX__)
+constexpr const size_t _simd_bytes = 32;
+#else
+constexpr const size_t _simd_bytes = 16;
+#endif
+
+// The vector attribute has to be attached to a declaration, so
+// the vector types are declared as members of a class template.
+template<typename T>
+struct simd_vector_type {
+  typedef T type __attribute__((vector_size(_simd_bytes)));
+};
+
+template<typename T>
+using simd_vector = typename simd_vector_type<T>::type;
+
+// The integer type of the lane indices used to shuffle vectors of T
+template<typename T>
+using simd_index_t = std::conditional_t<sizeof(T) == 1, int8_t,
+                     std::conditional_t<sizeof(T) == 2, int16_t,
+                     std::conditional_t<sizeof(T) == 4, int32_t, int64_t>>>;
+
+template<typename T>
+simd_vector<T> simd_load(const T* p) {
+  simd_vector<T> v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+template<typename T>
+void simd_store(T* p, simd_vector<T> v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+template<typename T, size_t... I>
+simd_vector<T> simd_splat(T x, std::index_sequence<I...>) {
+  return simd_vector<T>{((void)I, x)...};
+}
+
+// Returns the vector whose first K lanes are taken from fill, followed
+// by the first W-K lanes of x, i.e., x shifted up by K lanes.
+template<size_t K, typename T, size_t... I>
+simd_vector<T> simd_shift_in(simd_vector<T> fill, simd_vector<T> x, std::index_sequence<I...>) {
+  constexpr size_t W = sizeof...(I);
+#if defined(__clang__)
+  return __builtin_shufflevector(fill, x, (I < K ? I : W + I - K)...);
+#else
+  using index_type = simd_index_t<T>;
+  return __builtin_shuffle(fill, x, simd_vector<index_type>{static_cast<index_type>(I < K ? I : W + I - K)...});
+#endif
+}
+
+// Returns true if any lane of the vector is nonzero
+template<typename V>
+bool simd_any(V v) {
+  uint64_t words[sizeof(V) / sizeof(uint64_t)];
+  std::memcpy(words, &v, sizeof(V));
+  uint64_t r = 0;
+  for (size_t i = 0; i < sizeof(V) / sizeof(uint64_t); i++) r |= words[i];
+  return r != 0;
+}
+
+// In-register inclusive prefix of the lanes of x in log2(W) steps
+template<typename Op, size_t K, typename T, size_t... I>
+simd_vector<T> simd_prefix(simd_vector<T> x, simd_vector<T> id, std::index_sequence<I...> lanes) {
+  if constexpr (K < sizeof...(I)) {
+    x = Op::apply(x, simd_shift_in<K, T>(id, x, lanes));
+    return simd_prefix<Op, 2 * K, T>(x, id, lanes);
+  }
+  else {
+    return x;
+  }
+}
+
+// Reduce A[0], ..., A[n-1] starting from the identity. Uses two independent
+// vector accumulators to hide the latency of the vector operation.
+template<typename Monoid, typename T>
+T simd_reduce(const T* A, size_t n, T identity) {
+  using Op = simd_monoid<std::remove_cv_t<std::remove_reference_t<Monoid>>>;
+  constexpr size_t W = _simd_bytes / sizeof(T);
+  auto lanes = std::make_index_sequence<W>();
+  auto acc0 = simd_splat(identity, lanes);
+  auto acc1 = acc0;
+  size_t i = 0;
+  for (; i + 2 * W <= n; i += 2 * W) {
+    acc0 = Op::apply(acc0, simd_load(A + i));
+    acc1 = Op::apply(acc1, simd_load(A + i + W));
+  }
+  for (; i + W <= n; i += W) {
+    acc0 = Op::apply(acc0, simd_load(A + i));
+  }
+  acc0 = Op::apply(acc0, acc1);
+  T r = identity;
+  for (size_t j = 0; j < W; j++) r = Op::apply(r, acc0[j]);
+  for (; i < n; i++) r = Op::apply(r, A[i]);
+  return r;
+}
+
+// Scan In[0], ..., In[n-1] into Out starting from offset, and return the
+// total. In and Out may be the same array.
+template<typename Monoid, typename T>
+T simd_scan(const T* In, T* Out, size_t n, T offset, T identity, bool inclusive) {
+  using Op = simd_monoid<std::remove_cv_t<std::remove_reference_t<Monoid>>>;
+  constexpr size_t W = _simd_bytes / sizeof(T);
+  auto lanes = std::make_index_sequence<W>();
+  auto id = simd_splat(identity, lanes);
+  auto carry = simd_splat(offset, lanes);
+  size_t i = 0;
+  for (; i + W <= n; i += W) {
+    auto x = simd_prefix<Op, 1, T>(simd_load(In + i), id, lanes);
+    auto incl = Op::apply(carry, x);
+    if (inclusive) simd_store(Out + i, incl);
+    else simd_store(Out + i, simd_shift_in<1, T>(carry, incl, lanes));
+    carry = simd_splat(static_cast<T>(incl[W - 1]), lanes);
+  }
+  T r = carry[0];
+  if (inclusive) {
+    for (; i < n; i++) Out[i] = r = Op::apply(r, In[i]);
+  } else {
+    for (; i < n; i++) {
+      T t = In[i];
+      Out[i] = r;
+      r = Op::apply(r, t);
+    }
+  }
+  return r;
+}
+
+// Stream compaction. The compress kernels write the elements whose flags
+// are set to the output in order. A vector of elements is compacted with
+// vpcompress on AVX-512, or on AVX2 with a permutation looked up by the
+// bits of its flags, and is then written with one full vector store. The
+// lanes past the compacted elements are overwritten by the next store, so
+// full stores are only used while the output has room for a whole vector.
+// The remaining elements, and all of them on other targets, are each
+// written at the end of the output, which only advances past the elements
+// that are kept, so there is no branch on the flags to mispredict. The
+// output must hold exactly the kept elements, so that neither kind of
+// store writes past the last of them.
+
+// The bits of eight consecutive bools, the first in the lowest bit. The
+// multiplication moves the low bit of byte j to bit 56+j without carries.
+inline uint32_t simd_bool_mask8(const bool* Fl) {
+  uint64_t x;
+  std::memcpy(&x, Fl, sizeof(x));
+  return static_cast<uint32_t>((x * UINT64_C(0x0102040810204080)) >> 56);
+}
+
+inline uint32_t simd_bool_mask4(const bool* Fl) {
+  uint32_t x;
+  std::memcpy(&x, Fl, sizeof(x));
+  return (x * UINT32_C(0x01020408)) >> 24;
+}
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+
+// For each mask of eight 32-bit lanes, the indices of the lanes that are
+// set, in order, packed into the nibbles of a word
+struct simd_compress_table {
+  uint32_t entries[256];
+  constexpr simd_compress_table() : entries() {
+    for (uint32_t m = 0; m < 256; m++) {
+      uint32_t e = 0;
+      uint32_t k = 0;
+      for (uint32_t j = 0; j < 8; j++) {
+        if (m & (1u << j)) e |= j << (4 * k++);
+      }
+      entries[m] = e;
+    }
+  }
+};
+
+inline constexpr simd_compress_table _simd_compress_table{};
+
+// Moves the 32-bit lanes of v whose bits are set in m to the front
+inline __m256i simd_compress_epi32(__m256i v, uint32_t m) {
+  __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+  __m256i perm = _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(_simd_compress_table.entries[m])), shifts);
+  return _mm256_permutevar8x32_epi32(v, perm);
+}
+
+#endif
+
+// Compacts the n values produced by the element and vector functions. The
+// value at position i is elem(i), and the W values starting at position i
+// are vec(i), where W is the number of lanes in a vector. cap must be the
+// number of flags that are set, and Out must have room for exactly cap
+// elements. Returns the number written, which is cap.
+template<typename T, typename Elem, typename Vec>
+size_t simd_compress_with([[maybe_unused]] const Vec& vec, const Elem& elem, const bool* Fl,
+                          size_t n, T* Out, size_t cap) {
+  size_t i = 0;
+  size_t k = 0;
+#if defined(__AVX512F__)
+  constexpr size_t W = 64 / sizeof(T);
+  for (; i + W <= n && k + W <= cap; i += W) {
+    __m512i v = vec(i);
+    uint32_t m = simd_bool_mask8(Fl + i);
+    if constexpr (sizeof(T) == 4) {
+      m |= simd_bool_mask8(Fl + i + 8) << 8;
+      v = _mm512_maskz_compress_epi32(static_cast<__mmask16>(m), v);
+    } else {
+      v = _mm512_maskz_compress_epi64(static_cast<__mmask8>(m), v);
+    }
+    _mm512_storeu_si512(static_cast<void*>(Out + k), v);
+    k += static_cast<size_t>(__builtin_popcount(m));
+  }
+#elif defined(__AVX2__)
+  constexpr size_t W = 32 / sizeof(T);
+  for (; i + W <= n && k + W <= cap; i += W) {
+    uint32_t m;
+    size_t count;
+    if constexpr (sizeof(T) == 4) {
+      m = simd_bool_mask8(Fl + i);
+      count = static_cast<size_t>(__builtin_popcount(m));
+    } else {
+      // Each 64-bit lane moves as two 32-bit lanes
+      m = simd_bool_mask4(Fl + i);
+      count = static_cast<size_t>(__builtin_popcount(m));
+      m = (m & 1) * 0x3 | (m & 2) * 0x6 | (m & 4) * 0xc | (m & 8) * 0x18;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(Out + k), simd_compress_epi32(vec(i), m));
+    k += count;
+  }
+#endif
+  for (; i < n && k < cap; i++) {
+    Out[k] = elem(i);
+    k += Fl[i];
+  }
+  assert(k == cap);
+  return k;
+}
+
+// Writes the elements In[i] for i < n such that Fl[i] is true to Out,
+// which has room for exactly the cap of them, and returns cap.
+template<typename T>
+size_t simd_compress(const T* In, const bool* Fl, size_t n, T* Out, size_t cap) {
+  auto elem = [In](size_t i) { return In[i]; };
+#if defined(__AVX512F__)
+  auto vec = [In](size_t i) { return _mm512_loadu_si512(static_cast<const void*>(In + i)); };
+#elif defined(__AVX2__)
+  auto vec = [In](size_t i) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(In + i)); };
+#else
+  auto vec = elem;
+#endif
+  return simd_compress_with(vec, elem, Fl, n, Out, cap);
+}
+
+// The same as simd_compress for the indices start, start + 1, ...,
+// start + n - 1, which are computed rather than read.
+template<typename T>
+size_t simd_compress_index(size_t start, const bool* Fl, size_t n, T* Out, size_t cap) {
+  static_assert(std::is_integral_v<T>);
+  auto elem = [start](size_t i) { return static_cast<T>(start + i); };
+#if defined(__AVX512F__)
+  auto vec = [start](size_t i) {
+    if constexpr (sizeof(T) == 4) {
+      return _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(start + i)),
+                              _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    } else {
+      return _mm512_add_epi64(_mm512_set1_epi64(static_cast<long long>(start + i)),
+                              _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+  };
+#elif defined(__AVX2__)
+  auto vec = [start](size_t i) {
+    if constexpr (sizeof(T) == 4) {
+      return _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(start + i)),
+                              _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    } else {
+      return _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(start + i)),
+                              _mm256_setr_epi64x(0, 1, 2, 3));
+    }
+  };
+#else
+  auto vec = elem;
+#endif
+  return simd_compress_with(vec, elem, Fl, n, Out, cap);
+}
+
+#endif  // PARLAY_SIMD_KERNELS
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_SIMD_KERNELS_H_
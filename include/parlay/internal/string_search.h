@@ -0,0 +1,248 @@
+
+#ifndef PARLAY_INTERNAL_STRING_SEARCH_H_
+#define PARLAY_INTERNAL_STRING_SEARCH_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "sequence_ops.h"
+#include "simd_kernels.h"
+
+#include "../monoid.h"
+#include "../parallel.h"
+#include "../range.h"
+#include "../sequence.h"
+#include "../type_traits.h"
+#include "../utilities.h"
+
+namespace parlay {
+namespace internal {
+
+// Finding all occurrences of one or more patterns in a text. The text is
+// split into chunks of _search_chunk_size starting positions, and each chunk
+// is searched independently, reading past its end by the length of the
+// longest pattern minus one so that matches that cross into the next chunk
+// are found by the chunk in which they start. The matches of each chunk are
+// collected locally and then packed into one sequence in order.
+
+constexpr const size_t _search_chunk_size = 1 << 16;
+
+// Packs the sequences of matches found by each chunk into one sequence
+template <typename T>
+sequence<T> flatten_matches(const sequence<sequence<T>>& matches) {
+  auto offsets = sequence<size_t>::from_function(matches.size(),
+    [&](size_t i) { return matches[i].size(); });
+  size_t total = scan_inplace(make_slice(offsets), addm<size_t>());
+  auto R = sequence<T>::uninitialized(total);
+  parallel_for(0, matches.size(), [&](size_t i) {
+    std::uninitialized_copy(matches[i].begin(), matches[i].end(), R.begin() + offsets[i]);
+  }, 1);
+  return R;
+}
+
+// Calls report(i) for each i in [s, e) at which the pattern P of length
+// m > 0 occurs in the text A, in increasing order. A[e+m-2] must exist.
+// Candidates are filtered by comparing the first and last elements of the
+// pattern before comparing the rest, which rejects almost every position
+// in typical text after two comparisons.
+template <typename TextIterator, typename PatternIterator, typename BinaryPred, typename F>
+void find_all_serial(TextIterator A, size_t s, size_t e, PatternIterator P, size_t m,
+                     const BinaryPred& eq, F&& report) {
+  const auto& first = P[0];
+  const auto& last = P[m - 1];
+  for (size_t i = s; i < e; i++) {
+    if (eq(A[i], first) && eq(A[i + m - 1], last)) {
+      size_t j = 1;
+      while (j + 1 < m && eq(A[i + j], P[j])) j++;
+      if (j + 1 >= m) report(i);
+    }
+  }
+}
+
+#ifdef PARLAY_SIMD_KERNELS
+
+// The same as find_all_serial for arrays of integers compared with ==,
+// testing the first and last elements at a full vector of positions at once
+template <typename T, typename F>
+void find_all_simd(const T* A, size_t s, size_t e, const T* P, size_t m, F&& report) {
+  constexpr size_t W = _simd_bytes / sizeof(T);
+  auto lanes = std::make_index_sequence<W>();
+  auto first = simd_splat(P[0], lanes);
+  auto last = simd_splat(P[m - 1], lanes);
+  size_t i = s;
+  for (; i + W <= e; i += W) {
+    auto candidates = (simd_load(A + i) == first) & (simd_load(A + i + m - 1) == last);
+    if (!simd_any(candidates)) continue;
+    for (size_t j = 0; j < W; j++) {
+      if (candidates[j] && (m <= 2 || std::memcmp(A + i + j + 1, P + 1, (m - 2) * sizeof(T)) == 0)) {
+        report(i + j);
+      }
+    }
+  }
+  find_all_serial(A, i, e, P, m, std::equal_to<T>(), report);
+}
+
+#endif  // PARLAY_SIMD_KERNELS
+
+// Returns the positions of all occurrences of the pattern P in the text A
+// in increasing order, including overlapping ones. An empty pattern has
+// no occurrences.
+template <typename Text, typename Pattern, typename BinaryPred>
+sequence<size_t> find_all(const Text& A, const Pattern& P, const BinaryPred& eq) {
+  size_t n = A.size();
+  size_t m = P.size();
+  if (m == 0 || m > n) return {};
+  size_t num_starts = n - m + 1;
+  size_t num_chunks = num_blocks(num_starts, _search_chunk_size);
+  auto matches = sequence<sequence<size_t>>::from_function(num_chunks, [&](size_t c) {
+    size_t s = c * _search_chunk_size;
+    size_t e = (std::min)(s + _search_chunk_size, num_starts);
+    sequence<size_t> found;
+    auto report = [&](size_t i) { found.push_back(i); };
+#ifdef PARLAY_SIMD_KERNELS
+    using T = std::remove_cv_t<std::remove_reference_t<decltype(*A.begin())>>;
+    using U = std::remove_cv_t<std::remove_reference_t<decltype(*P.begin())>>;
+    if constexpr (is_contiguous_iterator_v<decltype(A.begin())> &&
+                  is_contiguous_iterator_v<decltype(P.begin())> &&
+                  std::is_same_v<T, U> && std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                  std::is_same_v<BinaryPred, std::equal_to<>>) {
+      find_all_simd(&*A.begin(), s, e, &*P.begin(), m, report);
+      return found;
+    }
+#endif
+    find_all_serial(A.begin(), s, e, P.begin(), m, eq, report);
+    return found;
+  }, 1);
+  return flatten_matches(matches);
+}
+
+// An Aho-Corasick automaton over bytes, which finds the occurrences of
+// any number of patterns in one pass over the text. Every state has a
+// transition for every byte, so the scan does one table lookup per byte.
+// A state that completes one or more patterns lists them, and links to
+// the next state along its chain of suffixes that completes a pattern.
+class aho_corasick {
+  static constexpr uint32_t none = static_cast<uint32_t>(-1);
+  static constexpr size_t alphabet = 256;
+
+ public:
+  template <typename Patterns>
+  explicit aho_corasick(const Patterns& patterns) : num_states(1), max_length(0) {
+    size_t k = parlay::size(patterns);
+    next = sequence<uint32_t>(alphabet, 0);
+    output = sequence<uint32_t>(1, none);
+    lengths = sequence<size_t>::uninitialized(k);
+    same = sequence<uint32_t>(k, none);
+
+    // Insert the patterns into a trie, in which a transition to state 0,
+    // the root, means that the child does not exist
+    for (size_t p = 0; p < k; p++) {
+      const auto& P = std::begin(patterns)[p];
+      size_t len = parlay::size(P);
+      lengths[p] = len;
+      if (len == 0) continue;
+      max_length = (std::max)(max_length, len);
+      uint32_t s = 0;
+      for (size_t j = 0; j < len; j++) {
+        size_t c = static_cast<unsigned char>(std::begin(P)[j]);
+        if (next[s * alphabet + c] == 0) {
+          next[s * alphabet + c] = static_cast<uint32_t>(num_states++);
+          next.append(sequence<uint32_t>(alphabet, 0));
+          output.push_back(none);
+        }
+        s = next[s * alphabet + c];
+      }
+      same[p] = output[s];
+      output[s] = static_cast<uint32_t>(p);
+    }
+
+    // Compute the suffix links in breadth-first order, and fill in the
+    // missing transitions with those of the suffix link
+    sequence<uint32_t> fail(num_states, 0);
+    dict = sequence<uint32_t>(num_states, 0);
+    sequence<uint32_t> queue;
+    for (size_t c = 0; c < alphabet; c++) {
+      if (next[c] != 0) queue.push_back(next[c]);
+    }
+    for (size_t q = 0; q < queue.size(); q++) {
+      uint32_t u = queue[q];
+      for (size_t c = 0; c < alphabet; c++) {
+        uint32_t v = next[u * alphabet + c];
+        if (v != 0) {
+          uint32_t f = next[fail[u] * alphabet + c];
+          fail[v] = f;
+          dict[v] = (output[f] != none) ? f : dict[f];
+          queue.push_back(v);
+        } else {
+          next[u * alphabet + c] = next[fail[u] * alphabet + c];
+        }
+      }
+    }
+  }
+
+  // The length of the longest pattern
+  size_t longest() const { return max_length; }
+
+  // Scans A[s], ..., A[e-1] from the root, and calls report(i, p) for
+  // each occurrence of pattern p that starts at a position i < limit
+  template <typename TextIterator, typename F>
+  void scan(TextIterator A, size_t s, size_t e, size_t limit, F&& report) const {
+    uint32_t state = 0;
+    for (size_t i = s; i < e; i++) {
+      state = next[state * alphabet + static_cast<unsigned char>(A[i])];
+      for (uint32_t t = (output[state] != none) ? state : dict[state]; t != 0; t = dict[t]) {
+        for (uint32_t p = output[t]; p != none; p = same[p]) {
+          size_t start = i + 1 - lengths[p];
+          if (start < limit) report(start, static_cast<size_t>(p));
+        }
+      }
+    }
+  }
+
+ private:
+  size_t num_states;
+  size_t max_length;
+  sequence<uint32_t> next;      // The transitions of each state
+  sequence<uint32_t> output;    // The last pattern inserted that ends at each state
+  sequence<uint32_t> same;      // The previous pattern inserted that is equal to each pattern
+  sequence<uint32_t> dict;      // The next state on the suffix chain that ends a pattern
+  sequence<size_t> lengths;     // The length of each pattern
+};
+
+// Returns the pairs (i, p) such that pattern p occurs at position i of the
+// text A, including overlapping occurrences, sorted by position and then
+// by pattern. The elements of the text and the patterns must be one byte.
+template <typename Text, typename Patterns>
+sequence<std::pair<size_t, size_t>> find_all_patterns(const Text& A, const Patterns& patterns) {
+  using match = std::pair<size_t, size_t>;
+  size_t n = A.size();
+  aho_corasick automaton(patterns);
+  size_t len = automaton.longest();
+  if (len == 0 || n == 0) return {};
+  size_t num_chunks = num_blocks(n, _search_chunk_size);
+  auto matches = sequence<sequence<match>>::from_function(num_chunks, [&](size_t c) {
+    size_t s = c * _search_chunk_size;
+    size_t e = (std::min)(s + _search_chunk_size, n);
+    sequence<match> found;
+    automaton.scan(A.begin(), s, (std::min)(n, e + len - 1), e,
+      [&](size_t i, size_t p) { found.push_back(match(i, p)); });
+    // Matches are found in order of their end positions
+    std::sort(found.begin(), found.end());
+    return found;
+  }, 1);
+  return flatten_matches(matches);
+}
+
+}  // namespace internal
+}  // namespace parlay
+
+#endif  // PARLAY_INTERNAL_STRING_SEARCH_H_
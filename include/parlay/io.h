@@ -68,6 +68,7 @@ inline std::ostream& operator<<(std::ostream& os, const sequence<char>& s) {
 }
 
 #include "internal/file_map.h"  // IWYU pragma: export
+#include "internal/file_allocator.h"  // IWYU pragma: export
 
 namespace parlay {
 
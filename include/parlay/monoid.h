@@ -8,6 +8,7 @@
 #include <array>
 #include <iterator>
 #include <limits>
+#include <type_traits>
 #include <utility>
 
 // Definition of various monoids
@@ -31,6 +32,44 @@ monoid<F, T> make_monoid(F f, T id) {
   return monoid<F, T>(f, id);
 }
 
+// Combining values in place. A monoid on a type that is expensive to copy,
+// such as strings or sequences, can define a member function
+//
+//   void combine_into(T& acc, const T& x)
+//
+// that sets acc to f(acc, x) by updating it, e.g., by appending x to it.
+// reduce, scan and collect_reduce accumulate with combine_into(m, acc, x),
+// which uses it if it exists, and otherwise passes acc to m.f as an rvalue
+// if m.f accepts one, so that an f that takes its first argument by value
+// or by rvalue reference can reuse its storage.
+
+template <class M, class T, class U, class = void>
+struct has_combine_into : std::false_type {};
+
+template <class M, class T, class U>
+struct has_combine_into<M, T, U, std::void_t<decltype(
+    std::declval<const M&>().combine_into(std::declval<T&>(), std::declval<U>()))>> : std::true_type {};
+
+template <class M, class T, class U, class = void>
+struct combines_rvalue : std::false_type {};
+
+template <class M, class T, class U>
+struct combines_rvalue<M, T, U, std::void_t<decltype(
+    std::declval<const M&>().f(std::declval<T&&>(), std::declval<U>()))>> : std::true_type {};
+
+template <class M, class T, class U>
+void combine_into(const M& m, T& acc, U&& x) {
+  if constexpr (has_combine_into<M, T, U&&>::value) {
+    m.combine_into(acc, std::forward<U>(x));
+  }
+  else if constexpr (combines_rvalue<M, T, U&&>::value) {
+    acc = m.f(std::move(acc), std::forward<U>(x));
+  }
+  else {
+    acc = m.f(acc, std::forward<U>(x));
+  }
+}
+
 template <class M1, class M2>
 auto pair_monoid(M1 m1, M2 m2) {
   using P = std::pair<typename M1::T, typename M2::T>;
@@ -114,7 +153,7 @@ struct xorm {
 template <class TT>
 struct minmaxm {
   using T = std::pair<TT, TT>;
-  minmaxm() : identity(T(highest<T>(), lowest<T>())) {}
+  minmaxm() : identity(T(highest<TT>(), lowest<TT>())) {}
   T identity;
   static T f(T a, T b) {
     return T((std::min)(a.first, b.first), (std::max)(a.second, b.second));
@@ -4,11 +4,14 @@
 
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <cctype>
 
 #include <algorithm>
 #include <atomic>
 #include <functional>
+#include <limits>
 #include <type_traits>
 #include <utility>
 
@@ -16,6 +19,12 @@
 #include "internal/integer_sort.h"
 #include "internal/merge.h"
 #include "internal/merge_sort.h"
+#include "internal/partition.h"
+#include "internal/remove_duplicates.h"
+#include "internal/segmented_ops.h"
+#include "internal/select.h"
+#include "internal/set_ops.h"
+#include "internal/string_search.h"
 #include "internal/sequence_ops.h"     // IWYU pragma: export
 #include "internal/sample_sort.h"
 
@@ -63,9 +72,7 @@ using internal::delayed_map;
 template<PARLAY_RANGE_TYPE R_in, PARLAY_RANGE_TYPE R_out>
 void copy(const R_in& in, R_out&& out) {
   assert(parlay::size(out) >= parlay::size(in));
-  parallel_for(0, parlay::size(in), [&](size_t i) {
-    std::begin(out)[i] = std::begin(in)[i];
-  });
+  parallel_copy_n(std::begin(out), std::begin(in), parlay::size(in));
 }
 
 /* ---------------------- Reduce ---------------------- */
@@ -136,6 +143,70 @@ auto scan_inclusive_inplace(R&& r, Monoid&& m) {
     internal::fl_scan_inclusive);
 }
 
+/* ---------------- Segmented scans and reductions ---------------- */
+
+// Segments are given either by a range of bools, in which case every
+// element whose flag is true starts a new segment (the first element
+// always starts one), or by a range of m+1 integer offsets as in the
+// compressed sparse row format, in which case segment k consists of
+// the elements at positions offsets[k] to offsets[k+1]-1.
+
+namespace internal {
+
+template<typename R, typename S>
+auto make_segmentation(const R& r, const S& segments) {
+  using flag_type = range_value_type_t<S>;
+  if constexpr (std::is_same_v<flag_type, bool>) {
+    return flag_segmentation<S>(segments, parlay::size(r));
+  }
+  else {
+    static_assert(std::is_integral_v<flag_type>,
+      "Segments must be given by a range of bools or a range of integer offsets");
+    return offset_segmentation<S>(segments, parlay::size(r));
+  }
+}
+
+}  // namespace internal
+
+// Scan each segment of r independently with respect to the monoid m.
+// Returns the sequence of exclusive prefix sums within each segment.
+template<PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE S, typename Monoid>
+auto segmented_scan(const R& r, const S& segments, Monoid&& m) {
+  return internal::segmented_scan(make_slice(r), internal::make_segmentation(r, segments), m);
+}
+
+template<PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE S>
+auto segmented_scan(const R& r, const S& segments) {
+  using value_type = range_value_type_t<R>;
+  return segmented_scan(r, segments, addm<value_type>());
+}
+
+template<PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE S, typename Monoid>
+auto segmented_scan_inclusive(const R& r, const S& segments, Monoid&& m) {
+  return internal::segmented_scan(make_slice(r), internal::make_segmentation(r, segments), m,
+    internal::fl_scan_inclusive);
+}
+
+template<PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE S>
+auto segmented_scan_inclusive(const R& r, const S& segments) {
+  using value_type = range_value_type_t<R>;
+  return segmented_scan_inclusive(r, segments, addm<value_type>());
+}
+
+// Reduce each segment of r with respect to the monoid m. Returns a
+// sequence with one element per segment. Empty segments, which can
+// only be given by offsets, reduce to the identity.
+template<PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE S, typename Monoid>
+auto segmented_reduce(const R& r, const S& segments, Monoid&& m) {
+  return internal::segmented_reduce(make_slice(r), internal::make_segmentation(r, segments), m);
+}
+
+template<PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE S>
+auto segmented_reduce(const R& r, const S& segments) {
+  using value_type = range_value_type_t<R>;
+  return segmented_reduce(r, segments, addm<value_type>());
+}
+
 /* ----------------------- Pack ----------------------- */
 
 template<PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE BoolSeq>
@@ -164,6 +235,20 @@ auto pack_index(const BoolSeq& b) {
   return internal::pack_index<IndexType>(make_slice(b));
 }
 
+// Like pack and pack_into, but the elements are not necessarily in the
+// same order as in r. Makes one pass over the input.
+template<PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE BoolSeq>
+auto pack_unordered(const R& r, const BoolSeq& b) {
+  static_assert(std::is_convertible<decltype(*std::begin(b)), bool>::value);
+  return internal::pack_unordered(make_slice(r), make_slice(b));
+}
+
+template<PARLAY_RANGE_TYPE R_in, PARLAY_RANGE_TYPE BoolSeq, PARLAY_RANGE_TYPE R_out>
+auto pack_unordered_into(const R_in& in, const BoolSeq& b, R_out&& out) {
+  static_assert(std::is_convertible<decltype(*std::begin(b)), bool>::value);
+  return internal::pack_unordered_out(make_slice(in), make_slice(b), std::begin(out));
+}
+
 /* ----------------------- Filter --------------------- */
 
 // Return a sequence consisting of the elements x of
@@ -178,11 +263,28 @@ auto filter_into(const R_in& in, R_out& out, UnaryPred&& f) {
   return internal::filter_out(make_slice(in), make_slice(out), std::forward<UnaryPred>(f));
 }
 
-/* ----------------------- Partition --------------------- */
+// Like filter and filter_into, but the elements are not necessarily in the
+// same order as in r. Makes one pass over the input.
+template<PARLAY_RANGE_TYPE R, typename UnaryPred>
+auto unordered_filter(const R& r, UnaryPred&& f) {
+  return internal::filter_unordered(make_slice(r), std::forward<UnaryPred>(f));
+}
 
-// TODO: Partition
+template<PARLAY_RANGE_TYPE R_in, PARLAY_RANGE_TYPE R_out, typename UnaryPred>
+auto unordered_filter_into(const R_in& in, R_out& out, UnaryPred&& f) {
+  return internal::filter_unordered_out(make_slice(in), std::begin(out), std::forward<UnaryPred>(f));
+}
+
+/* ----------------------- Partition --------------------- */
 
-// TODO: nth element
+// Rearranges r in place such that the elements for which f returns true
+// precede those for which it returns false, and returns an iterator to
+// the first element of the second group. The order within each group is
+// not preserved. f may be called more than once on each element.
+template<PARLAY_RANGE_TYPE R, typename UnaryPred>
+auto partition(R&& r, UnaryPred&& f) {
+  return std::begin(r) + internal::partition(make_slice(r), f);
+}
 
 /* ----------------------- Merging --------------------- */
 
@@ -201,6 +303,61 @@ auto merge(const R1& r1, const R2& r2) {
   return merge(r1, r2, comp);
 }
 
+/* ----------------------- Set operations --------------------- */
+
+// Set operations on sorted ranges. The results are sorted sequences with
+// the same multiset semantics as the corresponding std:: algorithms,
+// e.g., an element that appears m times in r1 and n times in r2 appears
+// max(m,n) times in the union, min(m,n) times in the intersection,
+// max(m-n,0) times in the difference, and |m-n| times in the symmetric
+// difference. When one range is much smaller than the other, the
+// intersection and the difference take time roughly proportional to the
+// size of the smaller one times the log of the ratio of the sizes.
+
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2, typename Compare>
+auto set_union(const R1& r1, const R2& r2, Compare&& comp) {
+  return internal::set_operation<internal::set_op::set_union>(make_slice(r1), make_slice(r2), comp);
+}
+
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2>
+auto set_union(const R1& r1, const R2& r2) {
+  using value_type = range_value_type_t<R1>;
+  return set_union(r1, r2, std::less<value_type>{});
+}
+
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2, typename Compare>
+auto set_intersection(const R1& r1, const R2& r2, Compare&& comp) {
+  return internal::set_operation<internal::set_op::set_intersection>(make_slice(r1), make_slice(r2), comp);
+}
+
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2>
+auto set_intersection(const R1& r1, const R2& r2) {
+  using value_type = range_value_type_t<R1>;
+  return set_intersection(r1, r2, std::less<value_type>{});
+}
+
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2, typename Compare>
+auto set_difference(const R1& r1, const R2& r2, Compare&& comp) {
+  return internal::set_operation<internal::set_op::set_difference>(make_slice(r1), make_slice(r2), comp);
+}
+
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2>
+auto set_difference(const R1& r1, const R2& r2) {
+  using value_type = range_value_type_t<R1>;
+  return set_difference(r1, r2, std::less<value_type>{});
+}
+
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2, typename Compare>
+auto set_symmetric_difference(const R1& r1, const R2& r2, Compare&& comp) {
+  return internal::set_operation<internal::set_op::set_symmetric_difference>(make_slice(r1), make_slice(r2), comp);
+}
+
+template<PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2>
+auto set_symmetric_difference(const R1& r1, const R2& r2) {
+  using value_type = range_value_type_t<R1>;
+  return set_symmetric_difference(r1, r2, std::less<value_type>{});
+}
+
 /* ----------------------- Histograms --------------------- */
 
 // Compute a histogram of the values of A, with m buckets.
@@ -211,11 +368,91 @@ auto histogram(const R& A, Integer_ m) {
 
 /* -------------------- General Sorting -------------------- */
 
-// Sort the given sequence and return the sorted sequence
+namespace internal {
+
+// Integers of up to 64 bits, and IEEE-754 floats and doubles, are sorted
+// by an integer sort rather than a comparison sort when they are compared
+// by their default order, since no comparison function can then tell
+// equal integers apart
+template <typename T>
+inline constexpr bool is_radix_sortable_v =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= sizeof(uint64_t)) ||
+    (std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 &&
+     (sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t)));
+
+template <typename T, typename Compare>
+inline constexpr bool is_default_less_v =
+    std::is_same_v<std::decay_t<Compare>, std::less<T>> || std::is_same_v<std::decay_t<Compare>, std::less<>>;
+
+template <typename T, typename Compare>
+inline constexpr bool use_integer_sort_v = is_radix_sortable_v<T> && is_default_less_v<T, Compare>;
+
+// Maps an integer or a floating-point number to an unsigned integer of the
+// same width with the same order. Signed integers have their sign bit
+// flipped. Non-negative floats have their sign bit set, and negative ones
+// have all of their bits flipped, so that the keys of numbers that are not
+// NaN are ordered as by std::less. -0.0 and 0.0 compare equal, so both map
+// to the key of 0.0, and all NaNs map to the largest key, so they are
+// sorted after infinity.
+template <typename T>
+auto to_unsigned_key(T x) {
+  if constexpr (std::is_floating_point_v<T>) {
+    using U = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+    constexpr U sign = U{1} << (8 * sizeof(T) - 1);
+    if (x != x) return (std::numeric_limits<U>::max)();
+    if (x == 0) x = 0;
+    U bits;
+    std::memcpy(&bits, &x, sizeof(T));
+    return static_cast<U>((bits & sign) ? ~bits : (bits | sign));
+  } else if constexpr (std::is_signed_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<U>(static_cast<U>(x) ^ (U{1} << (8 * sizeof(T) - 1)));
+  } else {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<U>(x);
+  }
+}
+
+// Calls f(k, bits) with a key function k that maps the elements of In
+// to unsigned integers of the given number of bits in the same order as
+// key. The keys are offset by the smallest one in In, so that the integer
+// sort only processes as many bits as the range of the keys needs.
+template <typename Iterator, typename Key, typename F>
+auto with_radix_key(slice<Iterator, Iterator> In, const Key& key, F&& f) {
+  using K = decltype(to_unsigned_key(key(*In.begin())));
+  auto keys = delayed_seq<std::pair<K, K>>(In.size(), [&](size_t i) {
+    K k = to_unsigned_key(key(In[i]));
+    return std::make_pair(k, k);
+  });
+  auto [lo, hi] = internal::reduce(make_slice(keys), minmaxm<K>());
+  K range = (In.size() == 0) ? K{0} : static_cast<K>(hi - lo);
+  size_t bits = (range == (std::numeric_limits<K>::max)()) ? 8 * sizeof(K) : log2_up(size_t{range} + 1);
+  auto radix_key = [&key, lo = lo](const auto& x) { return static_cast<K>(to_unsigned_key(key(x)) - lo); };
+  return f(radix_key, bits);
+}
+
+template <typename Iterator, typename Key>
+auto radix_sort_by_key(slice<Iterator, Iterator> In, const Key& key) {
+  return with_radix_key(In, key, [&](const auto& k, size_t bits) {
+    return internal::integer_sort(In, k, bits); });
+}
+
+template <typename Iterator, typename Key>
+void radix_sort_by_key_inplace(slice<Iterator, Iterator> In, const Key& key, flags fl) {
+  with_radix_key(In, key, [&](const auto& k, size_t bits) {
+    internal::integer_sort_inplace(In, k, bits, fl); });
+}
+
+}  // namespace internal
+
+// Sort the given sequence and return the sorted sequence.
+//
+// Integers compared by std::less are sorted by an integer sort,
+// and other types by a comparison sort.
 template<PARLAY_RANGE_TYPE R>
 auto sort(const R& in) {
   using value_type = range_value_type_t<R>;
-  return internal::sample_sort(make_slice(in), std::less<value_type>());
+  return sort(in, std::less<value_type>());
 }
 
 // Sort the given sequence with respect to the given
@@ -223,23 +460,53 @@ auto sort(const R& in) {
 // for an element x < y in the sequence, comp(x,y) = true
 template<PARLAY_RANGE_TYPE R, typename Compare>
 auto sort(const R& in, Compare&& comp) {
-  return internal::sample_sort(make_slice(in), std::forward<Compare>(comp));
+  using value_type = range_value_type_t<R>;
+  if constexpr (internal::use_integer_sort_v<value_type, Compare>) {
+    return internal::radix_sort_by_key(make_slice(in), [](value_type x) { return x; });
+  } else {
+    return internal::sample_sort(make_slice(in), std::forward<Compare>(comp));
+  }
+}
+
+// Sort the given sequence by the keys key(x) of its elements, in
+// increasing order. If the keys are integers, an integer sort is used.
+// Elements with equal keys may appear in any order.
+template<PARLAY_RANGE_TYPE R, typename Key>
+auto sort_by_key(const R& in, Key&& key) {
+  using key_type = std::decay_t<decltype(key(*std::begin(in)))>;
+  if constexpr (internal::is_radix_sortable_v<key_type>) {
+    return internal::radix_sort_by_key(make_slice(in), key);
+  } else {
+    using value_type = range_value_type_t<R>;
+    return internal::sample_sort(make_slice(in), [&](const value_type& a, const value_type& b) {
+      return key(a) < key(b); });
+  }
 }
 
 template<PARLAY_RANGE_TYPE R>
 auto stable_sort(const R& in) {
   using value_type = range_value_type_t<R>;
-  return internal::sample_sort(make_slice(in), std::less<value_type>{}, true);
+  return stable_sort(in, std::less<value_type>{});
 }
 
 template<PARLAY_RANGE_TYPE R, typename Compare>
 auto stable_sort(const R& in, Compare&& comp) {
-  return internal::sample_sort(make_slice(in), std::forward<Compare>(comp), true);
+  using value_type = range_value_type_t<R>;
+  if constexpr (internal::use_integer_sort_v<value_type, Compare>) {
+    return internal::radix_sort_by_key(make_slice(in), [](value_type x) { return x; });
+  } else {
+    return internal::sample_sort(make_slice(in), std::forward<Compare>(comp), true);
+  }
 }
 
 template<PARLAY_RANGE_TYPE R, typename Compare>
 void sort_inplace(R&& in, Compare&& comp) {
-  internal::sample_sort_inplace(make_slice(in), std::forward<Compare>(comp));
+  using value_type = range_value_type_t<R>;
+  if constexpr (internal::use_integer_sort_v<value_type, Compare>) {
+    internal::radix_sort_by_key_inplace(make_slice(in), [](value_type x) { return x; }, fl_low_memory);
+  } else {
+    internal::sample_sort_inplace(make_slice(in), std::forward<Compare>(comp));
+  }
 }
 
 template<PARLAY_RANGE_TYPE R>
@@ -248,9 +515,29 @@ void sort_inplace(R&& in) {
   sort_inplace(std::forward<R>(in), std::less<value_type>{});
 }
 
+template<PARLAY_RANGE_TYPE R, typename Key>
+void sort_by_key_inplace(R&& in, Key&& key) {
+  using key_type = std::decay_t<decltype(key(*std::begin(in)))>;
+  if constexpr (internal::is_radix_sortable_v<key_type>) {
+    internal::radix_sort_by_key_inplace(make_slice(in), key, fl_low_memory);
+  } else {
+    using value_type = range_value_type_t<R>;
+    internal::sample_sort_inplace(make_slice(in), [&](const value_type& a, const value_type& b) {
+      return key(a) < key(b); });
+  }
+}
+
 template<PARLAY_RANGE_TYPE R, typename Compare>
 void stable_sort_inplace(R&& in, Compare&& comp) {
-  internal::merge_sort_inplace(make_slice(in), std::forward<Compare>(comp));
+  using value_type = range_value_type_t<R>;
+  if constexpr (internal::use_integer_sort_v<value_type, Compare>) {
+    // Equal integers cannot be told apart, but -0.0 and 0.0 can, so floats
+    // need the stable integer sort
+    constexpr flags fl = std::is_integral_v<value_type> ? fl_low_memory : no_flag;
+    internal::radix_sort_by_key_inplace(make_slice(in), [](value_type x) { return x; }, fl);
+  } else {
+    internal::merge_sort_inplace(make_slice(in), std::forward<Compare>(comp));
+  }
 }
 
 template<PARLAY_RANGE_TYPE R>
@@ -261,36 +548,90 @@ void stable_sort_inplace(R&& in) {
 
 
 
+/* -------------------- Selection -------------------- */
+
+// Rearrange the elements of r such that r[k] is the element that would
+// be in that position if r were sorted, no element before it is greater,
+// and no element after it is less. Runs in O(n) expected work.
+template<PARLAY_RANGE_TYPE R, typename Compare>
+void nth_element(R&& r, size_t k, Compare&& comp) {
+  internal::nth_element(make_slice(r), k, std::forward<Compare>(comp));
+}
+
+template<PARLAY_RANGE_TYPE R>
+void nth_element(R&& r, size_t k) {
+  using value_type = range_value_type_t<R>;
+  nth_element(std::forward<R>(r), k, std::less<value_type>{});
+}
+
+// Rearrange the elements of r such that the first k of them are the k
+// smallest in sorted order. The order of the rest is unspecified. Runs
+// in O(n + k log k) expected work.
+template<PARLAY_RANGE_TYPE R, typename Compare>
+void partial_sort(R&& r, size_t k, Compare&& comp) {
+  internal::partial_sort(make_slice(r), k, std::forward<Compare>(comp));
+}
+
+template<PARLAY_RANGE_TYPE R>
+void partial_sort(R&& r, size_t k) {
+  using value_type = range_value_type_t<R>;
+  partial_sort(std::forward<R>(r), k, std::less<value_type>{});
+}
+
+// Return a sequence of the first k elements of r in the order given by
+// comp, i.e., the first k elements of sort(r, comp), without modifying r.
+// By default, returns the k largest elements in decreasing order. Runs
+// in O(n + k log k) expected work.
+template<PARLAY_RANGE_TYPE R, typename Compare>
+auto top_k(const R& r, size_t k, Compare&& comp) {
+  return internal::top_k(make_slice(r), k, std::forward<Compare>(comp));
+}
+
+template<PARLAY_RANGE_TYPE R>
+auto top_k(const R& r, size_t k) {
+  using value_type = range_value_type_t<R>;
+  return top_k(r, k, std::greater<value_type>{});
+}
+
 /* -------------------- Integer Sorting -------------------- */
 
-// Note: There is currently no stable integer sort.
+// The integer sorts are stable, except for integer_sort_inplace with
+// fl_low_memory.
 
+// The keys can be unsigned or signed integers, floats or doubles. They are
+// mapped to unsigned integers with the same order (see to_unsigned_key).
 template<PARLAY_RANGE_TYPE R>
 auto integer_sort(const R& in) {
-  static_assert(std::is_integral_v<std::remove_reference_t<decltype(*in.begin())>>);
-  static_assert(std::is_unsigned_v<std::remove_reference_t<decltype(*in.begin())>>);
-  return internal::integer_sort(make_slice(in), [](auto x) { return x; }); 
+  using value_type = range_value_type_t<R>;
+  static_assert(internal::is_radix_sortable_v<value_type>);
+  return internal::radix_sort_by_key(make_slice(in), [](value_type x) { return x; });
 }
 
 template<PARLAY_RANGE_TYPE R, typename Key>
 auto integer_sort(const R& in, Key&& key) {
-  static_assert(std::is_integral_v<std::remove_reference_t<decltype(key(*in.begin()))>>);
-  static_assert(std::is_unsigned_v<std::remove_reference_t<decltype(key(*in.begin()))>>);
-  return internal::integer_sort(make_slice(in), std::forward<Key>(key));
+  static_assert(internal::is_radix_sortable_v<std::decay_t<decltype(key(*in.begin()))>>);
+  return internal::radix_sort_by_key(make_slice(in), key);
 }
 
 template<PARLAY_RANGE_TYPE R>
 void integer_sort_inplace(R&& in) {
-  static_assert(std::is_integral_v<std::remove_reference_t<decltype(*in.begin())>>);
-  static_assert(std::is_unsigned_v<std::remove_reference_t<decltype(*in.begin())>>);
-  internal::integer_sort_inplace(make_slice(in), [](auto x) { return x; });
+  using value_type = range_value_type_t<R>;
+  static_assert(internal::is_radix_sortable_v<value_type>);
+  internal::radix_sort_by_key_inplace(make_slice(in), [](value_type x) { return x; }, no_flag);
 }
 
 template<PARLAY_RANGE_TYPE R, typename Key>
 void integer_sort_inplace(R&& in, Key&& key) {
-  static_assert(std::is_integral_v<std::remove_reference_t<decltype(key(*in.begin()))>>);
-  static_assert(std::is_unsigned_v<std::remove_reference_t<decltype(key(*in.begin()))>>);
-  internal::integer_sort_inplace(make_slice(in), std::forward<Key>(key));
+  static_assert(internal::is_radix_sortable_v<std::decay_t<decltype(key(*in.begin()))>>);
+  internal::radix_sort_by_key_inplace(make_slice(in), key, no_flag);
+}
+
+// With fl_low_memory, sorts with an in-place radix sort that needs only a
+// small amount of extra memory per worker, but is not stable
+template<PARLAY_RANGE_TYPE R, typename Key>
+void integer_sort_inplace(R&& in, Key&& key, flags fl) {
+  static_assert(internal::is_radix_sortable_v<std::decay_t<decltype(key(*in.begin()))>>);
+  internal::radix_sort_by_key_inplace(make_slice(in), key, fl);
 }
 
 /* -------------------- Internal count and find -------------------- */
@@ -478,6 +819,30 @@ auto search(R1&& r1, const R2& r2) {
   return search(r1, r2, eq);
 }
 
+// Returns the positions of all occurrences of r2 in r1, including
+// overlapping ones, in increasing order. An empty r2 has no occurrences.
+template <PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2, typename BinaryPred>
+sequence<size_t> find_all(const R1& r1, const R2& r2, BinaryPred pred) {
+  return internal::find_all(make_slice(r1), make_slice(r2), pred);
+}
+
+template <PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2>
+sequence<size_t> find_all(const R1& r1, const R2& r2) {
+  return internal::find_all(make_slice(r1), make_slice(r2), std::equal_to<>());
+}
+
+// Returns the pairs (i, j) such that patterns[j] occurs at position i of r,
+// including overlapping occurrences, sorted by i and then by j. The elements
+// of r and of the patterns must be bytes, e.g., char. Empty patterns have no
+// occurrences.
+template <PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE Patterns>
+auto find_all_patterns(const R& r, const Patterns& patterns) {
+  static_assert(sizeof(range_value_type_t<R>) == 1 &&
+                sizeof(range_value_type_t<range_value_type_t<Patterns>>) == 1,
+                "find_all_patterns requires byte-sized elements");
+  return internal::find_all_patterns(make_slice(r), patterns);
+}
+
 /* ------------------------- Equal ------------------------- */
 
 template <PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2, class BinaryPred>
@@ -572,7 +937,7 @@ auto minmax_element(R&& r) {
 template <PARLAY_RANGE_TYPE R>
 auto reverse(const R& r) {
   auto n = parlay::size(r);
-  return sequence<range_value_type_t<R>>::from_function(
+  return sequence<range_value_type_t<R>>::from_function(n,
     [n, it = std::begin(r)](size_t i) {
       return it[n - i - 1];
     });
@@ -589,11 +954,11 @@ auto reverse_inplace(R&& r) {
 template <PARLAY_RANGE_TYPE R>
 auto rotate(const R& r, size_t t) {
   size_t n = parlay::size(r);
-  return sequence<range_value_type_t<R>>::from_function(parlay::size(r),
-    [n, t, it = std::begin(r)](size_t i) {
-      size_t j = (i < t) ? n - t + i : i - t;
-      return it[j];
-    });
+  auto it = std::begin(r);
+  auto res = sequence<range_value_type_t<R>>::uninitialized(n);
+  parallel_copy_n<true>(res.begin(), it + (n - t), t);
+  parallel_copy_n<true>(res.begin() + t, it, n - t);
+  return res;
 }
 
 /* -------------------- Is sorted? -------------------- */
@@ -658,19 +1023,63 @@ auto iota(Index n) {
   return delayed_seq<Index>(n, [&](size_t i) -> Index { return i; });
 }
 
+/* -------------------- Nested parallel loops -------------------- */
+
+// Runs the nested loop over rows i in [0, n) and columns j in [0, m_i) in
+// parallel, where offsets is a range of n + 1 nondecreasing integers such
+// that m_i = offsets[i+1] - offsets[i], e.g. the prefix sums of the row
+// sizes followed by their total. Rather than one parallel loop per row, the
+// iterations of all rows are split into chunks of about granularity
+// iterations (or a default if it is zero), counting each row as one extra
+// iteration, and each chunk is run sequentially. f(i, s, e) is called with
+// each nonempty segment [s, e) of row i that falls into a chunk, so a row
+// may be split over several calls, and a chunk may call f for many short
+// rows.
+//
+// The work is balanced no matter how skewed the row sizes are, and short
+// rows do not pay the overhead of a parallel loop each.
+template <PARLAY_RANGE_TYPE R, typename F>
+void parallel_for_nested(const R& offsets, F&& f, size_t granularity = 0) {
+  assert(parlay::size(offsets) > 0);
+  if (granularity == 0) granularity = internal::_block_size;
+  size_t n = parlay::size(offsets) - 1;
+  auto it = std::begin(offsets);
+  // The amount of work before row i, which is strictly increasing in i
+  auto work = [&](size_t i) -> size_t { return static_cast<size_t>(it[i] - it[0]) + i; };
+  size_t total = work(n);
+  size_t num_chunks = internal::num_blocks(total, granularity);
+  parallel_for(0, num_chunks, [&](size_t c) {
+    size_t lo = c * granularity;
+    size_t hi = (std::min)(lo + granularity, total);
+    // The last row whose work starts at or before lo
+    size_t l = 0, r = n;
+    while (r - l > 1) {
+      size_t mid = l + (r - l) / 2;
+      if (work(mid) <= lo) l = mid; else r = mid;
+    }
+    for (size_t i = l; i < n && work(i) < hi; i++) {
+      // The first unit of work of a row is the row itself
+      size_t first = work(i) + 1;
+      size_t s = (std::max)(lo, first) - first;
+      size_t e = (std::min)(hi, work(i + 1)) - first;
+      if (s < e) f(i, s, e);
+    }
+  }, 1);
+}
+
 /* -------------------- Flatten -------------------- */
 
 template <PARLAY_RANGE_TYPE R>
 auto flatten(const R& r) {
   using T = range_value_type_t<range_value_type_t<R>>;
-  auto offsets = sequence<size_t>::from_function(parlay::size(r),
-    [it = std::begin(r)](size_t i) { return parlay::size(it[i]); });
+  size_t n = parlay::size(r);
+  auto offsets = sequence<size_t>::from_function(n + 1,
+    [n, it = std::begin(r)](size_t i) { return (i < n) ? parlay::size(it[i]) : 0; });
   size_t len = internal::scan_inplace(make_slice(offsets), addm<size_t>());
   auto res = sequence<T>::uninitialized(len);
-  parallel_for(0, parlay::size(r), [&, it = std::begin(r)](size_t i) {
-    parallel_for(0, parlay::size(it[i]),
-      [&](size_t j) { assign_uninitialized(res[offsets[i] + j], it[i][j]); }
-     );
+  parallel_for_nested(offsets, [&, it = std::begin(r)](size_t i, size_t s, size_t e) {
+    auto out = res.begin() + offsets[i];
+    parallel_copy_n<true>(out + s, std::begin(it[i]) + s, e - s);
   });
   return res;
 }
@@ -789,13 +1198,30 @@ auto remove_duplicates_ordered (const R& s, Compare less) {
       return !less(a,b) && !less(b,a);});
 }
 
+// Returns the distinct elements of r in the order of their first occurrence,
+// where hash and eq are a hash function and an equality on the elements, as
+// for std::unordered_set. Takes expected linear work and does not sort.
+template <PARLAY_RANGE_TYPE R, class Hash, class Equal>
+auto remove_duplicates (const R& r, Hash hash, Equal eq) {
+  return internal::remove_duplicates(make_slice(r), hash, eq);
+}
+
+template <PARLAY_RANGE_TYPE R>
+auto remove_duplicates (const R& r) {
+  using T = range_value_type_t<R>;
+  return remove_duplicates(r, std::hash<T>(), std::equal_to<T>());
+}
+
 // returns sequence with elementof same type as the first argument
 template <PARLAY_RANGE_TYPE R1, PARLAY_RANGE_TYPE R2>
 auto append (const R1& s1, const R2& s2) {
   using T = range_value_type_t<R1>;
-  size_t n1 = s1.size();
-  return tabulate(n1 + s2.size(), [&] (size_t i) -> T {
-      return (i < n1) ? s1[i] : s2[i-n1];});
+  size_t n1 = parlay::size(s1);
+  size_t n2 = parlay::size(s2);
+  auto res = sequence<T>::uninitialized(n1 + n2);
+  parallel_copy_n<true>(res.begin(), std::begin(s1), n1);
+  parallel_copy_n<true>(res.begin() + n1, std::begin(s2), n2);
+  return res;
 }
 
 }  // namespace parlay
@@ -2,12 +2,20 @@
 #ifndef PARLAY_RANDOM_H_
 #define PARLAY_RANDOM_H_
 
+#include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include "delayed_sequence.h"
+#include "monoid.h"
 #include "parallel.h"
 #include "range.h"
 #include "sequence.h"
@@ -15,25 +23,401 @@
 #include "utilities.h"
 
 #include "internal/counting_sort.h"
+#include "internal/integer_sort.h"
+#include "internal/select.h"
+#include "internal/sequence_ops.h"
+#include "internal/simd_kernels.h"
 
 namespace parlay {
 
-// A cheap version of an inteface that should be improved
-// Allows forking a state into multiple states
+namespace internal {
+
+// Philox4x32-10, the counter-based generator of Salmon et al., "Parallel
+// Random Numbers: As Easy as 1, 2, 3" (SC 2011). It is a keyed bijection
+// on 128-bit counters, so random numbers are obtained by applying it to
+// consecutive counters, which needs no state to be carried from one number
+// to the next. It passes the BigCrush battery of statistical tests.
+constexpr uint32_t philox_m0 = 0xD2511F53;
+constexpr uint32_t philox_m1 = 0xCD9E8D57;
+constexpr uint32_t philox_w0 = 0x9E3779B9;
+constexpr uint32_t philox_w1 = 0xBB67AE85;
+constexpr int philox_rounds = 10;
+
+inline void philox_round(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3,
+                         uint32_t k0, uint32_t k1) {
+  uint64_t p0 = uint64_t{philox_m0} * c0;
+  uint64_t p1 = uint64_t{philox_m1} * c2;
+  uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+  uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+  c1 = static_cast<uint32_t>(p1);
+  c3 = static_cast<uint32_t>(p0);
+  c0 = n0;
+  c2 = n2;
+}
+
+// Applies Philox4x32-10 with the key (k0, k1) to the counter c in place
+inline void philox4x32(uint32_t (&c)[4], uint32_t k0, uint32_t k1) {
+  for (int r = 0; r < philox_rounds; r++) {
+    philox_round(c[0], c[1], c[2], c[3], k0, k1);
+    k0 += philox_w0;
+    k1 += philox_w1;
+  }
+}
+
+#ifdef PARLAY_SIMD_KERNELS
+
+// Philox4x32-10 on the counters [i, i + U*W) at once, where W is the number
+// of 64-bit lanes of a vector. Each 32-bit word of the state is held in the
+// low half of a 64-bit lane, so that each 32x32-bit product is one vector
+// multiply. The high halves of the lanes are left with garbage that is
+// masked off before it is used. U independent vectors are interleaved to
+// hide the latency of the multiplies.
+template <size_t U, size_t... I>
+void simd_philox_pairs(uint32_t k0, uint32_t k1, uint64_t i, uint64_t* first, uint64_t* second,
+                       std::index_sequence<I...> lanes) {
+  using V = simd_vector<uint64_t>;
+  constexpr size_t W = sizeof...(I);
+  const V low = simd_splat(uint64_t{0xFFFFFFFF}, lanes);
+  const V m0 = simd_splat(uint64_t{philox_m0}, lanes);
+  const V m1 = simd_splat(uint64_t{philox_m1}, lanes);
+  V c0[U], c1[U], c2[U], c3[U];
+  for (size_t u = 0; u < U; u++) {
+    V ctr = V{(i + u * W + I)...};
+    c0[u] = ctr & low;
+    c1[u] = ctr >> 32;
+    c2[u] = V{};
+    c3[u] = V{};
+  }
+  for (int r = 0; r < philox_rounds; r++) {
+    V r0 = simd_splat(uint64_t{k0}, lanes);
+    V r1 = simd_splat(uint64_t{k1}, lanes);
+    for (size_t u = 0; u < U; u++) {
+      V p0 = (c0[u] & low) * m0;
+      V p1 = (c2[u] & low) * m1;
+      c0[u] = (p1 >> 32) ^ c1[u] ^ r0;
+      c2[u] = (p0 >> 32) ^ c3[u] ^ r1;
+      c1[u] = p1;
+      c3[u] = p0;
+    }
+    k0 += philox_w0;
+    k1 += philox_w1;
+  }
+  for (size_t u = 0; u < U; u++) {
+    simd_store(first + u * W, (c0[u] & low) | (c1[u] << 32));
+    simd_store(second + u * W, (c2[u] & low) | (c3[u] << 32));
+  }
+}
+
+#endif  // PARLAY_SIMD_KERNELS
+
+// Writes the two 64-bit halves of the output for each counter i in
+// [s, e) to first[i-s] and second[i-s]
+inline void philox_pairs(uint64_t key, uint64_t s, uint64_t e, uint64_t* first, uint64_t* second) {
+  uint32_t k0 = static_cast<uint32_t>(key);
+  uint32_t k1 = static_cast<uint32_t>(key >> 32);
+  uint64_t i = s;
+#ifdef PARLAY_SIMD_KERNELS
+  constexpr size_t W = _simd_bytes / sizeof(uint64_t);
+  constexpr size_t U = 4;
+  for (; i + U * W <= e; i += U * W) {
+    simd_philox_pairs<U>(k0, k1, i, first + (i - s), second + (i - s), std::make_index_sequence<W>());
+  }
+#endif
+  for (; i < e; i++) {
+    uint32_t c[4] = {static_cast<uint32_t>(i), static_cast<uint32_t>(i >> 32), 0, 0};
+    philox4x32(c, k0, k1);
+    first[i - s] = c[0] | (uint64_t{c[1]} << 32);
+    second[i - s] = c[2] | (uint64_t{c[3]} << 32);
+  }
+}
+
+}  // namespace internal
+
+// A counter-based random number generator. The i'th random number is a
+// function of the seed and i alone, so any number of them can be generated
+// in parallel, in any order, and always give the same results. Forking
+// gives independent generators, e.g. one per task.
+//
+// The generator is Philox4x32-10 keyed by the seed. Applying it to the
+// counter i gives the i'th pair of 64-bit random numbers, which are the
+// (2i)'th and (2i+1)'th random numbers. Each call to ith_rand computes a
+// whole pair and returns one half of it, which costs several times as much
+// as a hash, so loops over many numbers should use random_bits, rand_pairs
+// or ith_rand_pair instead.
 struct random {
  public:
   random(size_t seed) : state(seed){};
   random() : state(0){};
   random fork(uint64_t i) const { return random(static_cast<size_t>(hash64(hash64(i + state)))); }
   random next() const { return fork(0); }
-  size_t ith_rand(uint64_t i) const { return static_cast<size_t>(hash64(i + state)); }
+  size_t ith_rand(uint64_t i) const {
+    auto [a, b] = ith_rand_pair(i / 2);
+    return static_cast<size_t>((i % 2 == 0) ? a : b);
+  }
   size_t operator[](size_t i) const { return ith_rand(i); }
   size_t rand() { return ith_rand(0); }
 
+  // The (2i)'th and (2i+1)'th random numbers
+  std::pair<uint64_t, uint64_t> ith_rand_pair(uint64_t i) const {
+    uint64_t first, second;
+    internal::philox_pairs(state, i, i + 1, &first, &second);
+    return std::make_pair(first, second);
+  }
+
+  // Writes the i'th pair of random numbers for each i in [s, e) to
+  // first[i-s] and second[i-s]. Generating many pairs at once is
+  // several times faster than generating them one at a time.
+  void rand_pairs(uint64_t s, uint64_t e, uint64_t* first, uint64_t* second) const {
+    internal::philox_pairs(state, s, e, first, second);
+  }
+
+  // A hash of the seed and i, which is what ith_rand was before the
+  // generator was Philox. It is several times cheaper than ith_rand, but
+  // does not pass the same statistical tests. random_shuffle uses it.
+  size_t ith_rand_hash(uint64_t i) const { return static_cast<size_t>(hash64(i + state)); }
+
+ private:
+  uint64_t state = 0;
+};
+
+namespace internal {
+
+// The source of random bits for the i'th sample of a distribution. The
+// first two words are the i'th pair of random numbers of r, which are all
+// that most distributions use. Distributions that reject some samples draw
+// any further words from the generator forked from r by i, a pair at a time.
+class sample_bits {
+ public:
+  sample_bits(const random& r_, uint64_t i_, uint64_t first_, uint64_t second_)
+      : r(r_), i(i_), words{first_, second_}, used(0) {}
+
+  uint64_t operator()() {
+    size_t k = used++;
+    if (k >= 2 && k % 2 == 0) std::tie(words[0], words[1]) = r.fork(i).ith_rand_pair(k / 2 - 1);
+    return words[k % 2];
+  }
+
+ private:
+  const random& r;
+  uint64_t i;
+  uint64_t words[2];
+  size_t used;
+};
+
+// A uniform value in [0, 1) with as many random bits as the mantissa of T
+template <typename T>
+T uniform_01(uint64_t x) {
+  static_assert(std::is_floating_point_v<T>);
+  constexpr int bits = (std::min)(std::numeric_limits<T>::digits, 64);
+  return static_cast<T>(x >> (64 - bits)) * (T{1} / static_cast<T>(uint64_t{1} << (bits - 1)) / 2);
+}
+
+// A uniform value in (0, 1], which can be passed to log
+template <typename T>
+T uniform_01_nonzero(uint64_t x) {
+  return T{1} - uniform_01<T>(x);
+}
+
+// Generates the samples [0, n) of a distribution in parallel, by generating
+// the random numbers they use in blocks and transforming them.
+template <typename Distribution, typename F>
+void generate_samples(size_t n, const Distribution& dist, const random& r, F&& write) {
+  sliced_for(n, _block_size, [&](size_t, size_t s, size_t e) {
+    uint64_t first[_block_size], second[_block_size];
+    r.rand_pairs(s, e, first, second);
+    for (size_t i = s; i < e; i++) {
+      sample_bits bits(r, i, first[i - s], second[i - s]);
+      write(i, dist.sample(bits));
+    }
+  });
+}
+
+}  // namespace internal
+
+// The continuous uniform distribution on [a, b)
+template <typename T = double>
+class uniform_real_distribution {
+  static_assert(std::is_floating_point_v<T>);
+ public:
+  using result_type = T;
+  explicit uniform_real_distribution(T a_ = 0, T b_ = 1) : a(a_), b(b_) {}
+  result_type operator()(const random& r, uint64_t i) const {
+    auto [x, y] = r.ith_rand_pair(i);
+    internal::sample_bits bits(r, i, x, y);
+    return sample(bits);
+  }
+  template <typename Bits>
+  result_type sample(Bits& bits) const { return a + (b - a) * internal::uniform_01<T>(bits()); }
+ private:
+  T a, b;
+};
+
+// The normal distribution with the given mean and standard deviation,
+// sampled by the Box-Muller transform
+template <typename T = double>
+class normal_distribution {
+  static_assert(std::is_floating_point_v<T>);
+ public:
+  using result_type = T;
+  explicit normal_distribution(T mean_ = 0, T stddev_ = 1) : mean(mean_), stddev(stddev_) {}
+  result_type operator()(const random& r, uint64_t i) const {
+    auto [x, y] = r.ith_rand_pair(i);
+    internal::sample_bits bits(r, i, x, y);
+    return sample(bits);
+  }
+  template <typename Bits>
+  result_type sample(Bits& bits) const {
+    constexpr double two_pi = 6.283185307179586476925286766559;
+    double u = internal::uniform_01_nonzero<double>(bits());
+    double v = internal::uniform_01<double>(bits());
+    return mean + stddev * static_cast<T>(std::sqrt(-2 * std::log(u)) * std::cos(two_pi * v));
+  }
+ private:
+  T mean, stddev;
+};
+
+// The exponential distribution with the given rate lambda > 0
+template <typename T = double>
+class exponential_distribution {
+  static_assert(std::is_floating_point_v<T>);
+ public:
+  using result_type = T;
+  explicit exponential_distribution(T lambda_ = 1) : lambda(lambda_) { assert(lambda > 0); }
+  result_type operator()(const random& r, uint64_t i) const {
+    auto [x, y] = r.ith_rand_pair(i);
+    internal::sample_bits bits(r, i, x, y);
+    return sample(bits);
+  }
+  template <typename Bits>
+  result_type sample(Bits& bits) const {
+    return -std::log(internal::uniform_01_nonzero<T>(bits())) / lambda;
+  }
+ private:
+  T lambda;
+};
+
+// The geometric distribution of the number of failures before the first
+// success of independent trials that each succeed with probability p,
+// where 0 < p <= 1, sampled by inversion
+template <typename T = size_t>
+class geometric_distribution {
+  static_assert(std::is_integral_v<T>);
+ public:
+  using result_type = T;
+  explicit geometric_distribution(double p_ = 0.5) : p(p_), log_q(std::log1p(-p_)) {
+    assert(p > 0 && p <= 1);
+  }
+  result_type operator()(const random& r, uint64_t i) const {
+    auto [x, y] = r.ith_rand_pair(i);
+    internal::sample_bits bits(r, i, x, y);
+    return sample(bits);
+  }
+  template <typename Bits>
+  result_type sample(Bits& bits) const {
+    if (p == 1) return 0;
+    double k = std::floor(std::log(internal::uniform_01_nonzero<double>(bits())) / log_q);
+    constexpr double max_value = static_cast<double>((std::numeric_limits<T>::max)());
+    return (k < max_value) ? static_cast<T>(k) : (std::numeric_limits<T>::max)();
+  }
+ private:
+  double p, log_q;
+};
+
+// The Zipf distribution on the integers [1, n], in which k has probability
+// proportional to 1 / k^s for an exponent s > 0. It is sampled by the
+// rejection-inversion method of Hormann and Derflinger, "Rejection-inversion
+// to generate variates from monotone discrete distributions" (1996), which
+// takes constant expected time for any n and s, and rarely rejects.
+template <typename T = size_t>
+class zipf_distribution {
+  static_assert(std::is_integral_v<T>);
+ public:
+  using result_type = T;
+  explicit zipf_distribution(T n_ = 1, double s_ = 1) : n(n_), s(s_) {
+    assert(n >= 1 && s > 0);
+    h_integral_x1 = h_integral(1.5) - 1;
+    h_integral_n = h_integral(static_cast<double>(n) + 0.5);
+    cutoff = 2 - h_integral_inverse(h_integral(2.5) - h(2));
+  }
+  result_type operator()(const random& r, uint64_t i) const {
+    auto [x, y] = r.ith_rand_pair(i);
+    internal::sample_bits bits(r, i, x, y);
+    return sample(bits);
+  }
+  template <typename Bits>
+  result_type sample(Bits& bits) const {
+    while (true) {
+      double u = h_integral_n + internal::uniform_01<double>(bits()) * (h_integral_x1 - h_integral_n);
+      double x = h_integral_inverse(u);
+      double k = std::floor(x + 0.5);
+      k = (std::max)(1.0, (std::min)(k, static_cast<double>(n)));
+      if (k - x <= cutoff || u >= h_integral(k + 0.5) - h(k)) return static_cast<T>(k);
+    }
+  }
  private:
-  size_t state = 0;
+  // The density h(x) = 1 / x^s that is sampled from, its integral, and its inverse
+  double h(double x) const { return std::exp(-s * std::log(x)); }
+  double h_integral(double x) const {
+    double log_x = std::log(x);
+    return helper2((1 - s) * log_x) * log_x;
+  }
+  double h_integral_inverse(double x) const {
+    double t = (std::max)(-1.0, x * (1 - s));
+    return std::exp(helper1(t) * x);
+  }
+  // log(1 + x) / x and (exp(x) - 1) / x, which are accurate near 0
+  static double helper1(double x) {
+    return (std::abs(x) > 1e-8) ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+  }
+  static double helper2(double x) {
+    return (std::abs(x) > 1e-8) ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x * (1.0 / 3) * (1 + 0.25 * x));
+  }
+
+  T n;
+  double s;
+  double h_integral_x1, h_integral_n, cutoff;
 };
 
+// Returns the sequence of the samples [0, n) of the given distribution, i.e.
+// the i'th element is dist(r, i). The samples are generated in parallel in
+// blocks, and do not depend on the number of workers.
+template <typename Distribution>
+auto random_sequence(size_t n, const Distribution& dist, random r = random()) {
+  using T = typename Distribution::result_type;
+  auto out = sequence<T>::uninitialized(n);
+  internal::generate_samples(n, dist, r, [&](size_t i, T x) { assign_uninitialized(out[i], x); });
+  return out;
+}
+
+namespace internal {
+
+// Returns the sequence of r.ith_rand(i) & mask for i in [s, e), converted
+// to T. The numbers are generated in pairs, in blocks, using both halves.
+template <typename T>
+sequence<T> masked_random_bits(random r, uint64_t s, uint64_t e, uint64_t mask) {
+  auto out = sequence<T>::uninitialized(e - s);
+  uint64_t first_pair = s / 2;
+  uint64_t num_pairs = (e + 1) / 2 - first_pair;
+  sliced_for(num_pairs, _block_size, [&](size_t, size_t ps, size_t pe) {
+    uint64_t first[_block_size], second[_block_size];
+    r.rand_pairs(first_pair + ps, first_pair + pe, first, second);
+    for (size_t p = ps; p < pe; p++) {
+      uint64_t i = 2 * (first_pair + p);
+      if (i >= s) out[i - s] = static_cast<T>(first[p - ps] & mask);
+      if (i + 1 < e) out[i + 1 - s] = static_cast<T>(second[p - ps] & mask);
+    }
+  });
+  return out;
+}
+
+}  // namespace internal
+
+// Returns the sequence of the random numbers [0, n) of r, i.e. the i'th
+// element is r.ith_rand(i)
+inline sequence<uint64_t> random_bits(size_t n, random r = random()) {
+  return internal::masked_random_bits<uint64_t>(r, 0, n, ~uint64_t{0});
+}
+
 namespace internal {
 
 // inplace sequential version
@@ -43,7 +427,7 @@ void seq_random_shuffle_(slice<Iterator, Iterator> A, random r = random()) {
   size_t n = A.size();
   if (n < 2) return;
   for (size_t i=n-1; i > 0; i--)
-    std::swap(A[i],A[r.ith_rand(i)%(i+1)]);
+    std::swap(A[i],A[r.ith_rand_hash(i)%(i+1)]);
 }
 
 template <typename InIterator, typename OutIterator>
@@ -71,7 +455,7 @@ void random_shuffle_(slice<InIterator, InIterator> In,
   size_t num_buckets = (size_t{1} << bits);
   size_t mask = num_buckets - 1;
   auto rand_pos = [&] (size_t i) -> size_t {
-    return r.ith_rand(i) & mask;
+    return r.ith_rand_hash(i) & mask;
   };
 
   auto get_pos = delayed_seq<size_t>(n, rand_pos);
@@ -116,6 +500,246 @@ sequence<_Integer> random_permutation(size_t n, random r = random()) {
   return random_shuffle(id, r);
 }
 
+namespace internal {
+
+// A uniformly random subset of k of the integers [0, n), in increasing
+// order. Indices are drawn with replacement and deduplicated, in rounds
+// until at least k distinct ones have been drawn. By symmetry the set of
+// distinct indices is uniform given its size, so a random k of them are a
+// uniform sample. For k <= n/2 this takes O(k) expected work, and for
+// larger k, the complement of a sample of n - k indices is returned.
+inline sequence<size_t> sample_indices(size_t n, size_t k, random r) {
+  k = (std::min)(k, n);
+  if (k > n / 2) {
+    auto excluded = sample_indices(n, n - k, r);
+    sequence<bool> keep(n, true);
+    parallel_for(0, excluded.size(), [&](size_t i) { keep[excluded[i]] = false; });
+    return internal::pack_index<size_t>(make_slice(keep));
+  }
+  size_t bits = log2_up(n);
+  sequence<size_t> distinct;
+  for (size_t round = 0; distinct.size() < k; round++) {
+    // The expected number of draws to reach k distinct indices is
+    // n log((n - d) / (n - k)) when d have been drawn already
+    size_t d = distinct.size();
+    double expected = n * std::log(static_cast<double>(n - d) / static_cast<double>(n - k));
+    size_t m = static_cast<size_t>(1.1 * expected) + 16;
+    auto draws = masked_random_bits<uint64_t>(r.fork(round), 0, m, ~uint64_t{0});
+    auto all = sequence<size_t>::from_function(d + m, [&](size_t i) -> size_t {
+      return (i < d) ? distinct[i] : draws[i - d] % n; });
+    auto sorted = internal::integer_sort(make_slice(all), [](size_t x) { return x; }, bits);
+    auto first = delayed_seq<bool>(d + m, [&](size_t i) {
+      return i == 0 || sorted[i] != sorted[i - 1]; });
+    distinct = internal::pack(make_slice(sorted), make_slice(first));
+  }
+  if (distinct.size() > k) {
+    auto shuffled = sequence<size_t>::uninitialized(distinct.size());
+    random_shuffle_(make_slice(distinct), make_slice(shuffled), r.fork(n));
+    distinct = internal::integer_sort(make_slice(shuffled).cut(0, k), [](size_t x) { return x; }, bits);
+  }
+  return distinct;
+}
+
+}  // namespace internal
+
+// Returns a uniformly random sample of k of the elements of r without
+// replacement, in the order in which they appear in r. Takes O(k) expected
+// work when k is at most half of the size of r, and O(n) otherwise.
+template <PARLAY_RANGE_TYPE R>
+auto random_sample(const R& r, size_t k, random rng = random()) {
+  using T = range_value_type_t<R>;
+  auto In = make_slice(r);
+  auto indices = internal::sample_indices(In.size(), k, rng);
+  return sequence<T>::from_function(indices.size(), [&](size_t i) { return In[indices[i]]; });
+}
+
+// The discrete distribution on the integers [0, n) in which i has
+// probability proportional to the i'th of the given n non-negative
+// weights. It is sampled in constant time with an alias table, which
+// has a bucket for each i of probability 1/n. Bucket i returns i with
+// probability prob[i], and alias[i] otherwise.
+//
+// The table is built in parallel. The sequential construction sweeps over
+// the light elements, whose weight is less than the average, and fills
+// the rest of each one's bucket from the current heavy element, which
+// itself becomes light and is filled from the next heavy element once its
+// remaining weight drops below the average. Which heavy element is current
+// for each light element, and how much weight each heavy element has left
+// when it becomes light, are determined by prefix sums of the deficits of
+// the light elements and of the excesses of the heavy ones, so all of the
+// buckets are filled independently by binary searches over the prefix sums.
+template <typename T = size_t>
+class discrete_distribution {
+  static_assert(std::is_integral_v<T>);
+ public:
+  using result_type = T;
+
+  template <PARLAY_RANGE_TYPE R>
+  explicit discrete_distribution(const R& weights) {
+    auto W = make_slice(weights);
+    size_t n = W.size();
+    assert(n > 0);
+    auto w = internal::delayed_tabulate(n, [&](size_t i) { return static_cast<double>(W[i]); });
+    double avg = internal::reduce(w, addm<double>()) / n;
+    assert(avg > 0);
+    prob = sequence<double>::uninitialized(n);
+    alias = sequence<T>::uninitialized(n);
+
+    auto light = internal::pack_index<size_t>(delayed_seq<bool>(n, [&](size_t i) { return w[i] < avg; }));
+    auto heavy = internal::pack_index<size_t>(delayed_seq<bool>(n, [&](size_t i) { return !(w[i] < avg); }));
+    size_t nl = light.size(), nh = heavy.size();
+
+    // All of the weights are equal, up to rounding
+    if (nh == 0) {
+      parallel_for(0, n, [&](size_t i) {
+        prob[i] = 1;
+        alias[i] = static_cast<T>(i);
+      });
+      return;
+    }
+
+    // Inclusive prefix sums of the deficits of the light elements and the
+    // excesses of the heavy elements
+    auto deficits = internal::delayed_tabulate(nl, [&](size_t i) { return avg - w[light[i]]; });
+    auto excesses = internal::delayed_tabulate(nh, [&](size_t j) { return w[heavy[j]] - avg; });
+    auto light_sums = internal::scan(deficits, addm<double>(), internal::fl_scan_inclusive).first;
+    auto heavy_sums = internal::scan(excesses, addm<double>(), internal::fl_scan_inclusive).first;
+
+    // Light element i is filled by the first heavy element whose
+    // cumulative excess covers the deficits of the lights before i
+    parallel_for(0, nl, [&](size_t i) {
+      double before = (i == 0) ? 0.0 : light_sums[i - 1];
+      size_t j = std::lower_bound(heavy_sums.begin(), heavy_sums.end(), before) - heavy_sums.begin();
+      prob[light[i]] = w[light[i]] / avg;
+      alias[light[i]] = static_cast<T>(heavy[(std::min)(j, nh - 1)]);
+    });
+
+    // Heavy element j becomes light once the cumulative deficit exceeds the
+    // cumulative excess up to j, and is then filled by heavy element j + 1
+    parallel_for(0, nh, [&](size_t j) {
+      size_t k = std::upper_bound(light_sums.begin(), light_sums.end(), heavy_sums[j]) - light_sums.begin();
+      if (k == nl || j == nh - 1) {
+        prob[heavy[j]] = 1;
+        alias[heavy[j]] = static_cast<T>(heavy[j]);
+      } else {
+        double remaining = heavy_sums[j] + avg - light_sums[k];
+        prob[heavy[j]] = (std::max)(0.0, (std::min)(1.0, remaining / avg));
+        alias[heavy[j]] = static_cast<T>(heavy[j + 1]);
+      }
+    });
+  }
+
+  size_t size() const { return prob.size(); }
+
+  result_type operator()(const random& r, uint64_t i) const {
+    auto [x, y] = r.ith_rand_pair(i);
+    internal::sample_bits bits(r, i, x, y);
+    return sample(bits);
+  }
+  template <typename Bits>
+  result_type sample(Bits& bits) const {
+    size_t b = bits() % prob.size();
+    return (internal::uniform_01<double>(bits()) < prob[b]) ? static_cast<T>(b) : alias[b];
+  }
+
+ private:
+  sequence<double> prob;
+  sequence<T> alias;
+};
+
+// Returns a sample of k of the elements of r with replacement, where each
+// element is drawn with probability proportional to its weight
+template <PARLAY_RANGE_TYPE R, PARLAY_RANGE_TYPE W>
+auto weighted_random_sample(const R& r, const W& weights, size_t k, random rng = random()) {
+  using T = range_value_type_t<R>;
+  auto In = make_slice(r);
+  assert(In.size() == make_slice(weights).size());
+  discrete_distribution<size_t> dist(weights);
+  auto indices = random_sequence(k, dist, rng);
+  return sequence<T>::from_function(k, [&](size_t i) { return In[indices[i]]; });
+}
+
+// Maintains a uniformly random sample of k of the elements inserted so far,
+// without replacement, for streams that arrive in batches. Each element is
+// given a random key that depends only on its position in the stream, and
+// the sample is the k elements with the smallest keys. A batch is filtered
+// in parallel against the largest key in the sample and the k'th smallest
+// key in the batch, so at most k of its elements are copied.
+//
+// Since the smallest keys of a union are the smallest keys of the parts,
+// samplers of different streams can be merged into a sample of their union.
+// The samplers that are merged must use independent generators, e.g.,
+// different forks of the same generator.
+template <typename T>
+class reservoir_sampler {
+ public:
+  explicit reservoir_sampler(size_t k_, random r_ = random())
+      : k(k_), r(r_), seen(0), threshold((std::numeric_limits<uint64_t>::max)()) {}
+
+  template <PARLAY_RANGE_TYPE R>
+  void insert(const R& batch) {
+    auto In = make_slice(batch);
+    size_t m = In.size();
+    auto keys = internal::masked_random_bits<uint64_t>(r, seen, seen + m, ~uint64_t{0});
+    // Only the k smallest keys of the batch can enter the sample
+    uint64_t batch_max = (std::numeric_limits<uint64_t>::max)();
+    if (m > k && k > 0) {
+      auto smallest = keys;
+      internal::nth_element(make_slice(smallest), k - 1, std::less<uint64_t>());
+      batch_max = smallest[k - 1];
+    }
+    auto enters = delayed_seq<bool>(m, [&](size_t i) {
+      return keys[i] < threshold && keys[i] <= batch_max; });
+    auto positions = internal::pack_index<size_t>(enters);
+    auto entries = sequence<entry>::from_function(positions.size(), [&](size_t i) {
+      return entry(keys[positions[i]], In[positions[i]]); });
+    seen += m;
+    add(std::move(entries));
+  }
+
+  void merge(const reservoir_sampler& other) {
+    seen += other.seen;
+    add(other.items);
+  }
+
+  // The current sample, in no particular order
+  sequence<T> sample() const {
+    return sequence<T>::from_function(items.size(), [&](size_t i) { return items[i].second; });
+  }
+
+  size_t capacity() const { return k; }
+
+  // The number of elements inserted so far
+  size_t count() const { return seen; }
+
+ private:
+  using entry = std::pair<uint64_t, T>;
+
+  // Adds the given entries to the sample and keeps the k smallest keys
+  void add(sequence<entry> entries) {
+    if (entries.empty()) return;
+    items.append(std::move(entries));
+    if (items.size() > k) {
+      auto less = [](const entry& a, const entry& b) { return a.first < b.first; };
+      if (k > 0) internal::nth_element(make_slice(items), k - 1, less);
+      items = sequence<entry>(std::make_move_iterator(items.begin()),
+                              std::make_move_iterator(items.begin() + k));
+    }
+    if (items.size() == k && k > 0) {
+      auto keys = delayed_seq<uint64_t>(k, [&](size_t i) { return items[i].first; });
+      threshold = internal::reduce(keys, maxm<uint64_t>());
+    } else if (k == 0) {
+      threshold = 0;
+    }
+  }
+
+  size_t k;
+  random r;
+  size_t seen;
+  uint64_t threshold;
+  sequence<entry> items;
+};
+
 }  // namespace parlay
 
 #endif  // PARLAY_RANDOM_H_
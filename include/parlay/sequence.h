@@ -529,9 +529,7 @@ class sequence : protected sequence_internal::sequence_base<T, Allocator, Enable
   void initialize_range(_RandomAccessIterator first, _RandomAccessIterator last, std::random_access_iterator_tag) {
     auto n = std::distance(first, last);
     storage.initialize_capacity(n);
-    auto buffer = storage.data();
-    parallel_for(
-        0, n, [&](size_t i) { storage.initialize_explicit(buffer + i, first[i]); }, copy_granularity(n));
+    storage.initialize_copies(storage.data(), first, n);
     storage.set_size(n);
   }
 
@@ -598,8 +596,7 @@ class sequence : protected sequence_internal::sequence_base<T, Allocator, Enable
     auto n = std::distance(first, last);
     storage.ensure_capacity(size() + n);
     auto it = end();
-    parallel_for(
-        0, n, [&](size_t i) { storage.initialize_explicit(it + i, first[i]); }, copy_granularity(n));
+    storage.initialize_copies(it, first, n);
     storage.set_size(size() + n);
     return it;
   }
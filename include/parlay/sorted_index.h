@@ -0,0 +1,224 @@
+// A sorted index is an immutable search structure over a sorted sequence of
+// keys that answers lower_bound queries. It stores the keys in Eytzinger
+// (breadth-first) order, in which the nodes visited by a search are laid out
+// from the top of the tree down, so the first few levels stay in cache and
+// the next few levels can be prefetched while the current one is compared.
+// It is intended for answering large numbers of queries against static keys,
+// where a binary search over the sorted array is bound by cache misses.
+//
+// Example:
+//
+//   auto keys = parlay::tabulate(n, [](size_t i) -> long { return 2 * i; });
+//   auto index = parlay::sorted_index<long>(keys);
+//   size_t r = index.lower_bound(41);                   // r == 21
+//   auto rs = index.lower_bound(queries);               // in parallel
+//
+
+#ifndef PARLAY_SORTED_INDEX_H_
+#define PARLAY_SORTED_INDEX_H_
+
+#include <cassert>
+#include <cstddef>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "alloc.h"
+#include "parallel.h"
+#include "range.h"
+#include "sequence.h"
+#include "slice.h"
+#include "utilities.h"
+
+#include "internal/sequence_ops.h"
+
+namespace parlay {
+
+// The keys are stored in an array b[1..n] that represents a complete binary
+// search tree, in which the children of node k are the nodes 2k and 2k+1. A
+// search starts at node 1 and goes to 2k+1 if b[k] is less than the query and
+// to 2k otherwise, without branching. The answer is the last node at which the
+// search went left, which is recovered from the bits of the final node index.
+//
+// The descendants of node k that are d levels down are the 2^d consecutive
+// nodes starting at k * 2^d, so with a cache-line aligned array, one prefetch
+// brings in all of the nodes that the search can visit d levels later.
+//
+// Batched queries are processed in groups that descend the tree in lockstep.
+// The searches of a group are independent, so their cache misses overlap, and
+// for arithmetic keys the compiler can vectorize the comparisons of a level
+// across the group.
+template <typename T, typename Compare = std::less<T>>
+class sorted_index {
+
+  // The number of levels ahead that are prefetched, such that the
+  // nodes that are prefetched at once fit in one cache line
+  static constexpr size_t prefetch_levels =
+      (sizeof(T) == 1) ? 6 : (sizeof(T) == 2) ? 5 : (sizeof(T) <= 4) ? 4 : (sizeof(T) <= 8) ? 3 : 1;
+
+  // The number of queries in a group that descends the tree in lockstep
+  static constexpr size_t group_size = 16;
+
+  // Subtrees smaller than this are built sequentially
+  static constexpr size_t build_base = 4096;
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  sorted_index() : n(0), height(0) {}
+
+  // Build the index over the range r in parallel. The elements
+  // of r must be sorted with respect to less.
+  template<PARLAY_RANGE_TYPE R>
+  explicit sorted_index(const R& r, Compare less_ = {}) : less(std::move(less_)), n(parlay::size(r)),
+      height(0), keys(), ranks() {
+    if (n == 0) return;
+    while ((size_t{1} << height) <= n) height++;
+    keys = key_sequence::uninitialized(n + 1);
+    ranks = sequence<size_t>::uninitialized(n + 1);
+    auto it = std::begin(r);
+    // Slot 0 is not part of the tree. It represents the end of the keys.
+    assign_uninitialized(keys[0], it[0]);
+    ranks[0] = n;
+    build(it, 1, subtree_size(1), 0);
+  }
+
+  // The number of keys
+  size_t size() const { return n; }
+
+  bool empty() const { return n == 0; }
+
+  // The memory used by the index in bytes
+  size_t size_in_bytes() const {
+    return keys.size() * sizeof(T) + ranks.size() * sizeof(size_t);
+  }
+
+  // Return the rank of the first key that is not less than x, i.e.,
+  // the same as std::lower_bound on the sorted keys minus their begin.
+  size_t lower_bound(const T& x) const {
+    if (n == 0) return 0;
+    const T* b = keys.data();
+    size_t k = 1;
+    for (size_t level = 1; level < height; level++) {
+      prefetch(b, k);
+      k = 2 * k + static_cast<size_t>(less(b[k], x));
+    }
+    k = last_level(b, k, x);
+    return ranks[last_left_turn(k)];
+  }
+
+  // Return the sequence of lower_bound(x) for each x in the range
+  // of queries. The queries are answered in parallel. Arguments that
+  // convert to T are single queries, so they go to the overload above.
+  template<PARLAY_RANGE_TYPE R, typename = std::enable_if_t<!std::is_convertible_v<const R&, T>>>
+  sequence<size_t> lower_bound(const R& queries) const {
+    size_t m = parlay::size(queries);
+    auto q = std::begin(queries);
+    auto out = sequence<size_t>::uninitialized(m);
+    if (n == 0) {
+      parallel_for(0, m, [&](size_t i) { out[i] = 0; });
+      return out;
+    }
+    internal::sliced_for(m, internal::_block_size, [&](size_t, size_t s, size_t e) {
+      for (size_t i = s; i < e; i += group_size) {
+        if (i + group_size <= e) lower_bound_group<group_size>(q + i, out.begin() + i);
+        else for (size_t j = i; j < e; j++) out[j] = lower_bound(q[j]);
+      }
+    });
+    return out;
+  }
+
+ private:
+
+  using key_sequence = sequence<T, aligned_allocator<T>>;
+
+  // The number of nodes in the subtree rooted at node k
+  size_t subtree_size(size_t k) const {
+    size_t sz = 0;
+    for (size_t lo = k, hi = k; lo <= n; lo = 2 * lo, hi = 2 * hi + 1) {
+      sz += (std::min)(hi, n) - lo + 1;
+    }
+    return sz;
+  }
+
+  // Fill the subtree rooted at node k, which has sz nodes, with
+  // the sorted keys starting at it[start]. An in-order traversal
+  // of the tree visits the keys in sorted order.
+  template<typename Iterator>
+  void build(Iterator it, size_t k, size_t sz, size_t start) {
+    if (sz < build_base) {
+      build_serial(it, k, start);
+      return;
+    }
+    size_t left = subtree_size(2 * k);
+    assign_uninitialized(keys[k], it[start + left]);
+    ranks[k] = start + left;
+    par_do([&]() { build(it, 2 * k, left, start); },
+           [&]() { build(it, 2 * k + 1, sz - left - 1, start + left + 1); });
+  }
+
+  template<typename Iterator>
+  void build_serial(Iterator it, size_t k, size_t& i) {
+    if (k > n) return;
+    build_serial(it, 2 * k, i);
+    assign_uninitialized(keys[k], it[i]);
+    ranks[k] = i++;
+    build_serial(it, 2 * k + 1, i);
+  }
+
+  // Levels above the last are complete, so only the step from the last
+  // level needs to check whether the node exists. A search that ends at
+  // a missing node stops there, as if it had gone left.
+  size_t last_level(const T* b, size_t k, const T& x) const {
+    size_t next = 2 * k + static_cast<size_t>(less(b[(std::min)(k, n)], x));
+    return (k <= n) ? next : k;
+  }
+
+  // The search ends at a node below the answer, having gone right from
+  // the answer's left child onwards, so removing the trailing right turns
+  // and the last left turn gives the answer, or 0 if it never went left.
+  static size_t last_left_turn(size_t k) {
+#if defined(__GNUC__)
+    return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+#else
+    while (k & 1) k >>= 1;
+    return k >> 1;
+#endif
+  }
+
+  void prefetch([[maybe_unused]] const T* b, [[maybe_unused]] size_t k) const {
+#if defined(__GNUC__)
+    __builtin_prefetch(b + (std::min)(k << prefetch_levels, n));
+#endif
+  }
+
+  template<size_t G, typename QueryIterator, typename OutIterator>
+  void lower_bound_group(QueryIterator q, OutIterator out) const {
+    const T* b = keys.data();
+    size_t k[G];
+    for (size_t j = 0; j < G; j++) k[j] = 1;
+    for (size_t level = 1; level < height; level++) {
+      for (size_t j = 0; j < G; j++) {
+        prefetch(b, k[j]);
+        k[j] = 2 * k[j] + static_cast<size_t>(less(b[k[j]], q[j]));
+      }
+    }
+    for (size_t j = 0; j < G; j++) {
+      out[j] = ranks[last_left_turn(last_level(b, k[j], q[j]))];
+    }
+  }
+
+  Compare less;
+  size_t n;
+  size_t height;            // The number of levels of the tree
+  key_sequence keys;        // The keys in Eytzinger order, starting at index 1
+  sequence<size_t> ranks;   // The rank of each key in sorted order
+};
+
+}  // namespace parlay
+
+#endif  // PARLAY_SORTED_INDEX_H_
@@ -10,6 +10,7 @@
 //  - priority_tag
 //  - is_contiguous_iterator / is_random_access_iterator
 //  - is_trivial_allocator
+//  - allocator_alignment
 //  - is_trivially_relocatable / is_nothrow_relocatable
 //
 
@@ -132,6 +133,35 @@ inline constexpr bool is_trivial_allocator_v = is_trivial_allocator<Alloc, T>::v
 template<typename T>
 struct is_trivial_allocator<std::allocator<T>, T> : std::true_type {};
 
+/*  ----------------- Allocator alignment. ---------------------
+    An allocator can advertise that every buffer it returns is aligned
+    to some boundary, typically larger than the alignment of its value
+    type, by defining a static constexpr member named alignment (see,
+    e.g., parlay::aligned_allocator). Containers can then lay out their
+    buffers so that the elements themselves are aligned to it.
+
+    allocator_alignment<Alloc> is the advertised alignment, or zero if
+    the allocator does not advertise one.
+*/
+
+namespace internal {
+
+  template<typename Alloc>
+  auto allocator_alignment(priority_tag<1>)
+    -> std::integral_constant<size_t, Alloc::alignment>;
+
+  template<typename Alloc>
+  auto allocator_alignment(priority_tag<0>)
+    -> std::integral_constant<size_t, 0>;
+
+}  // namespace internal
+
+template<typename Alloc>
+struct allocator_alignment : decltype(internal::allocator_alignment<Alloc>(priority_tag<1>())) {};
+
+template<typename Alloc>
+inline constexpr size_t allocator_alignment_v = allocator_alignment<Alloc>::value;
+
 /*  ----------------- Trivially relocatable. ---------------------
     A type T is called trivially relocatable if, given a pointer
     p to an object of type T, and a pointer q to unintialized
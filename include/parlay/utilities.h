@@ -62,6 +62,7 @@ const flags fl_debug = 2;
 const flags fl_time = 4;
 const flags fl_conservative = 8;
 const flags fl_inplace = 16;
+const flags fl_low_memory = 32;
 
 template <typename T>
 inline void assign_uninitialized(T& a, const T& b) {
@@ -341,6 +342,40 @@ inline void uninitialized_relocate_n(Iterator1 to, Iterator2 from, size_t n) {
   uninitialized_relocate_n_a(to, from, n, a);
 }
 
+// Copy the n elements [from, from + n) to [to, to + n) in parallel. If
+// Uninitialized is true, [to, to + n) is uninitialized memory and the
+// elements are copy constructed into it, otherwise they are copy assigned.
+// The two ranges must not overlap.
+//
+// If both iterators are contiguous and the elements are trivially copyable
+// and of the same type, the copy is done by memcpy in large chunks, which
+// runs at the rate of the memory bandwidth. As with assign_uninitialized,
+// the uninitialized memory is assumed to be from a standard allocator.
+template<bool Uninitialized = false, typename It1, typename It2>
+inline void parallel_copy_n(It1 to, It2 from, size_t n) {
+  using T = typename std::iterator_traits<It1>::value_type;
+  using U = typename std::iterator_traits<It2>::value_type;
+  if constexpr (is_contiguous_iterator_v<It1> && is_contiguous_iterator_v<It2> &&
+                std::is_same_v<T, U> && std::is_trivially_copyable_v<T>) {
+    constexpr size_t chunk_size = (std::max)(size_t{1}, (size_t{1} << 16) / sizeof(T));
+    const size_t n_chunks = (n + chunk_size - 1) / chunk_size;
+    parallel_for(0, n_chunks, [&](size_t i) {
+      size_t n_objects = (std::min)(chunk_size, n - i * chunk_size);
+      void* dest = static_cast<void*>(std::addressof(*(to + i * chunk_size)));
+      const void* src = static_cast<const void*>(std::addressof(*(from + i * chunk_size)));
+      std::memcpy(dest, src, sizeof(T) * n_objects);
+    }, 1);
+  }
+  else if constexpr (Uninitialized) {
+    parallel_for(0, n, [&](size_t i) {
+      if constexpr (std::is_same_v<T, U>) assign_uninitialized(to[i], from[i]);
+      else assign_uninitialized(to[i], T(from[i]));
+    });
+  }
+  else {
+    parallel_for(0, n, [&](size_t i) { to[i] = from[i]; });
+  }
+}
 
 /* For inplace sorting / merging, we sometimes need to move values
    around and sometimes we want to make copies. We use tag dispatch
@@ -23,6 +23,19 @@ TEST(TestAllocator, TestParlayAllocator) {
   }
 }
 
+TEST(TestAllocator, TestAlignedAllocator) {
+  std::vector<int, parlay::aligned_allocator<int>> a;
+  for (int i = 0; i < 100000; i++) {
+    a.push_back(i);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(a.data()) % 64, 0);
+  }
+  for (int i = 0; i < 100000; i++) {
+    ASSERT_EQ(a[i], i);
+  }
+  std::vector<char, parlay::aligned_allocator<char, 4096>> b(100);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(b.data()) % 4096, 0);
+}
+
 TEST(TestAllocator, TestTypeAllocator) {
   using vector_allocator = parlay::type_allocator<std::vector<int>>;
   std::vector<int>* mem = vector_allocator::alloc();
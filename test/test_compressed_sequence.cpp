@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+#include <parlay/compressed_sequence.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+TEST(TestCompressedSequence, TestEmpty) {
+  parlay::sequence<uint64_t> s;
+  auto c = parlay::compressed_sequence<uint64_t>(s);
+  ASSERT_TRUE(c.empty());
+  ASSERT_EQ(c.size(), 0);
+  ASSERT_EQ(c.num_blocks(), 0);
+  ASSERT_TRUE(c.decode().empty());
+  ASSERT_EQ(c.reduce(parlay::addm<uint64_t>()), 0);
+}
+
+TEST(TestCompressedSequence, TestDefaultConstruct) {
+  parlay::compressed_sequence<int> c;
+  ASSERT_TRUE(c.empty());
+  ASSERT_EQ(c.reduce(parlay::addm<int>()), 0);
+}
+
+TEST(TestCompressedSequence, TestSorted) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> uint64_t { return 3 * i + (i % 3); });
+  auto c = parlay::compressed_sequence<uint64_t>(s);
+  ASSERT_EQ(c.size(), s.size());
+  ASSERT_EQ(c.decode(), s);
+  ASSERT_LT(c.size_in_bytes(), s.size() * sizeof(uint64_t) / 4);
+}
+
+TEST(TestCompressedSequence, TestRandom) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> uint64_t { return parlay::hash64(i); });
+  auto c = parlay::compress(s);
+  ASSERT_EQ(c.decode(), s);
+}
+
+TEST(TestCompressedSequence, TestSigned) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> int {
+    return static_cast<int>(parlay::hash64(i) % 2001) - 1000; });
+  auto c = parlay::compress(s);
+  ASSERT_EQ(c.decode(), s);
+  ASSERT_EQ(c.reduce(parlay::addm<int>()), parlay::reduce(s));
+}
+
+TEST(TestCompressedSequence, TestSmallType) {
+  auto s = parlay::tabulate(10000, [](size_t i) -> uint8_t { return static_cast<uint8_t>(parlay::hash64(i)); });
+  auto c = parlay::compress(s);
+  ASSERT_EQ(c.decode(), s);
+}
+
+TEST(TestCompressedSequence, TestExtremes) {
+  auto s = parlay::tabulate(1000, [](size_t i) -> int64_t {
+    return (i % 2 == 0) ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::lowest(); });
+  auto c = parlay::compress(s);
+  ASSERT_EQ(c.decode(), s);
+}
+
+TEST(TestCompressedSequence, TestSubscript) {
+  auto s = parlay::tabulate(10000, [](size_t i) -> uint32_t { return 5 * i * i; });
+  auto c = parlay::compress(s);
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(c[i], s[i]);
+  }
+}
+
+TEST(TestCompressedSequence, TestDecodeBlock) {
+  auto s = parlay::tabulate(1000, [](size_t i) -> uint32_t { return i; });
+  auto c = parlay::compress(s);
+  size_t b = 3;
+  size_t i = b * c.block_size;
+  c.decode_block(b, [&](uint32_t x) { ASSERT_EQ(x, s[i++]); });
+  ASSERT_EQ(i, (b + 1) * c.block_size);
+}
+
+TEST(TestCompressedSequence, TestReduce) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> uint64_t { return i; });
+  auto c = parlay::compress(s);
+  ASSERT_EQ(c.reduce(parlay::addm<uint64_t>()), parlay::reduce(s));
+  ASSERT_EQ(c.reduce(parlay::maxm<uint64_t>()), 999999);
+}
+
+TEST(TestCompressedSequence, TestMap) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> uint64_t { return 2 * i; });
+  auto c = parlay::compress(s);
+  auto m = c.map([](uint64_t x) { return x / 2; });
+  auto expected = parlay::tabulate(100000, [](size_t i) -> uint64_t { return i; });
+  ASSERT_EQ(m, expected);
+}
+
+TEST(TestCompressedSequence, TestMapReduce) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> uint64_t { return i; });
+  auto c = parlay::compress(s);
+  auto evens = c.map_reduce([](uint64_t x) -> size_t { return x % 2 == 0; }, parlay::addm<size_t>());
+  ASSERT_EQ(evens, 50000);
+}
@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <parlay/delayed.h>
+#include <parlay/delayed_sequence.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+TEST(TestDelayed, TestToSequence) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> int { return i; });
+  auto r = parlay::delayed::to_sequence(s);
+  ASSERT_EQ(r, s);
+}
+
+TEST(TestDelayed, TestEmpty) {
+  parlay::sequence<int> s;
+  ASSERT_TRUE(parlay::delayed::to_sequence(s).empty());
+  ASSERT_EQ(parlay::delayed::reduce(s), 0);
+  ASSERT_EQ(parlay::delayed::size(parlay::delayed::filter(s, [](int) { return true; })), 0);
+}
+
+TEST(TestDelayed, TestMap) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> long { return i; });
+  auto v = parlay::delayed::map(s, [](long x) { return 2 * x; });
+  auto r = parlay::delayed::to_sequence(v);
+  ASSERT_EQ(r, parlay::map(s, [](long x) { return 2 * x; }));
+}
+
+TEST(TestDelayed, TestFilter) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> long { return parlay::hash64(i) % 1000; });
+  auto pred = [](long x) { return x % 3 == 0; };
+  auto v = parlay::delayed::filter(s, pred);
+  ASSERT_EQ(parlay::delayed::to_sequence(v), parlay::filter(s, pred));
+  ASSERT_EQ(parlay::delayed::size(v), parlay::count_if(s, pred));
+}
+
+TEST(TestDelayed, TestMapFilterReduce) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> long { return i; });
+  auto v = parlay::delayed::filter(parlay::delayed::map(s, [](long x) { return x * x % 1001; }),
+                                   [](long x) { return x % 2 == 0; });
+  auto expected = parlay::reduce(parlay::filter(parlay::map(s, [](long x) { return x * x % 1001; }),
+                                                [](long x) { return x % 2 == 0; }));
+  ASSERT_EQ(parlay::delayed::reduce(v), expected);
+  ASSERT_EQ(parlay::delayed::reduce(v, parlay::addm<long>()), expected);
+}
+
+TEST(TestDelayed, TestDelayedSequenceInput) {
+  auto s = parlay::delayed_seq<long>(100000, [](size_t i) -> long { return i; });
+  auto v = parlay::delayed::filter(std::move(s), [](long x) { return x % 10 == 0; });
+  ASSERT_EQ(parlay::delayed::size(v), 10000);
+  ASSERT_EQ(parlay::delayed::reduce(v), 10 * 9999L * 10000L / 2);
+}
+
+TEST(TestDelayed, TestScan) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> long { return parlay::hash64(i) % 100; });
+  auto v = parlay::delayed::scan(s);
+  auto [expected, total] = parlay::scan(s);
+  ASSERT_EQ(parlay::delayed::to_sequence(v), expected);
+  ASSERT_EQ(v.get_total(), total);
+}
+
+TEST(TestDelayed, TestScanInclusive) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> long { return parlay::hash64(i) % 100; });
+  auto v = parlay::delayed::scan_inclusive(s, parlay::maxm<long>());
+  auto expected = parlay::scan_inclusive(s, parlay::maxm<long>());
+  ASSERT_EQ(parlay::delayed::to_sequence(v), expected);
+}
+
+TEST(TestDelayed, TestFilterScan) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> long { return i; });
+  auto pred = [](long x) { return x % 7 == 1; };
+  auto v = parlay::delayed::scan(parlay::delayed::filter(s, pred));
+  auto [expected, total] = parlay::scan(parlay::filter(s, pred));
+  ASSERT_EQ(parlay::delayed::to_sequence(v), expected);
+  ASSERT_EQ(v.get_total(), total);
+}
+
+TEST(TestDelayed, TestFlatten) {
+  auto s = parlay::tabulate(1000, [](size_t i) {
+    return parlay::tabulate(i % 17, [i](size_t j) -> int { return i + j; }); });
+  auto v = parlay::delayed::flatten(s);
+  ASSERT_EQ(parlay::delayed::to_sequence(v), parlay::flatten(s));
+  ASSERT_EQ(parlay::delayed::reduce(v), parlay::reduce(parlay::flatten(s)));
+}
+
+TEST(TestDelayed, TestZip) {
+  auto a = parlay::tabulate(100000, [](size_t i) -> int { return i; });
+  auto b = parlay::tabulate(50000, [](size_t i) -> long { return 2 * i; });
+  auto v = parlay::delayed::zip(a, b);
+  auto r = parlay::delayed::to_sequence(v);
+  ASSERT_EQ(r.size(), 50000);
+  for (size_t i = 0; i < r.size(); i++) {
+    ASSERT_EQ(r[i], std::make_pair((int)i, (long)(2 * i)));
+  }
+  auto dot = parlay::delayed::reduce(parlay::delayed::map(v, [](auto p) { return p.first * p.second; }));
+  long expected = 0;
+  for (size_t i = 0; i < 50000; i++) expected += (long)i * (long)(2 * i);
+  ASSERT_EQ(dot, expected);
+}
+
+TEST(TestDelayed, TestForEach) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> size_t { return i; });
+  auto seen = parlay::sequence<bool>(100000, false);
+  parlay::delayed::for_each(parlay::delayed::filter(s, [](size_t x) { return x % 2 == 0; }),
+                            [&](size_t x) { seen[x] = true; });
+  for (size_t i = 0; i < seen.size(); i++) {
+    ASSERT_EQ(seen[i], i % 2 == 0);
+  }
+}
+
+TEST(TestDelayed, TestNonTrivialType) {
+  auto s = parlay::tabulate(10000, [](size_t i) { return std::to_string(i); });
+  auto v = parlay::delayed::filter(s, [](const std::string& x) { return x.size() == 3; });
+  auto r = parlay::delayed::to_sequence(v);
+  ASSERT_EQ(r.size(), 900);
+  ASSERT_EQ(r[0], "100");
+  ASSERT_EQ(r[899], "999");
+}
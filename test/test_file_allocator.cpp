@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include <parlay/io.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+template<typename T>
+using file_sequence = parlay::sequence<T, parlay::file_allocator<T>>;
+
+TEST(TestFileAllocator, TestStdVector) {
+  std::vector<int, parlay::file_allocator<int>> a;
+  a.reserve(1000000);
+  for (int i = 0; i < 1000000; i++) {
+    a.push_back(i);
+  }
+  for (int i = 0; i < 1000000; i++) {
+    ASSERT_EQ(a[i], i);
+  }
+}
+
+TEST(TestFileAllocator, TestSmallSequence) {
+  auto s = file_sequence<int>(100, 5);
+  ASSERT_EQ(s.size(), 100);
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(s[i], 5);
+  }
+}
+
+TEST(TestFileAllocator, TestLargeSequence) {
+  auto s = file_sequence<long>::from_function(10000000, [](size_t i) -> long { return i; });
+  ASSERT_EQ(s.size(), 10000000);
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(s[i], (long)i);
+  }
+}
+
+TEST(TestFileAllocator, TestGrow) {
+  file_sequence<size_t> s;
+  for (size_t i = 0; i < 1000000; i++) {
+    s.push_back(i);
+  }
+  ASSERT_EQ(s.size(), 1000000);
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(s[i], i);
+  }
+}
+
+TEST(TestFileAllocator, TestCopyAndMove) {
+  auto s = file_sequence<int>::from_function(1000000, [](size_t i) -> int { return (i * 7) % 1000; });
+  auto s2 = s;
+  ASSERT_EQ(s, s2);
+  auto s3 = std::move(s);
+  ASSERT_EQ(s2, s3);
+  ASSERT_TRUE(s.empty());
+}
+
+TEST(TestFileAllocator, TestSortInplace) {
+  auto s = file_sequence<unsigned int>::from_function(1000000, [](size_t i) -> unsigned int {
+    return parlay::hash64(i) % 1000000; });
+  auto sorted = parlay::sort(s);
+  parlay::sort_inplace(s);
+  ASSERT_EQ(s.size(), sorted.size());
+  ASSERT_TRUE(std::equal(s.begin(), s.end(), sorted.begin()));
+  ASSERT_TRUE(std::is_sorted(s.begin(), s.end()));
+}
+
+TEST(TestFileAllocator, TestNested) {
+  auto s = file_sequence<file_sequence<int>>::from_function(1000, [](size_t i) {
+    return file_sequence<int>(i, (int)i); });
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(s[i].size(), i);
+    for (auto x : s[i]) ASSERT_EQ(x, (int)i);
+  }
+}
+
+TEST(TestFileAllocator, TestSetDirectory) {
+  auto old = parlay::file_allocator_directory();
+  parlay::set_file_allocator_directory(".");
+  ASSERT_EQ(parlay::file_allocator_directory(), ".");
+  auto s = file_sequence<int>(1000000, 1);
+  ASSERT_EQ(parlay::reduce(s), 1000000);
+  parlay::set_file_allocator_directory(old);
+}
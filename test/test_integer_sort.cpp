@@ -1,7 +1,10 @@
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <deque>
+#include <limits>
 #include <numeric>
 
 #include <parlay/primitives.h>
@@ -80,3 +83,110 @@ TEST(TestIntegerSort, TestIntegerSortCopyAndDestructiveMove) {
     ASSERT_EQ(real_sorted[i].value(), sorted[i].value());
   }
 }
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemory) {
+  auto s = parlay::tabulate(1000000, [](unsigned long long i) -> unsigned long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto sorted = s;
+  std::sort(std::begin(sorted), std::end(sorted));
+  parlay::integer_sort_inplace(s, [](auto x) { return x; }, parlay::fl_low_memory);
+  ASSERT_EQ(s, sorted);
+}
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemoryWideKeys) {
+  auto s = parlay::tabulate(1000000, [](unsigned long long i) -> unsigned long long {
+    return parlay::hash64(i);
+  });
+  auto sorted = s;
+  std::sort(std::begin(sorted), std::end(sorted));
+  parlay::integer_sort_inplace(s, [](auto x) { return x; }, parlay::fl_low_memory);
+  ASSERT_EQ(s, sorted);
+}
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemoryMaxKey) {
+  auto s = parlay::tabulate(100000, [](uint64_t i) -> uint64_t {
+    return (i % 3 == 0) ? UINT64_MAX : parlay::hash64(i);
+  });
+  auto sorted = s;
+  std::sort(std::begin(sorted), std::end(sorted));
+  parlay::integer_sort_inplace(s, [](auto x) { return x; }, parlay::fl_low_memory);
+  ASSERT_EQ(s, sorted);
+}
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemoryFewKeys) {
+  for (unsigned int keys : {1u, 2u, 3u, 100u}) {
+    auto s = parlay::tabulate(500000, [&](unsigned int i) -> unsigned int {
+      return (50021 * i + 61) % keys;
+    });
+    auto sorted = s;
+    std::sort(std::begin(sorted), std::end(sorted));
+    parlay::integer_sort_inplace(s, [](auto x) { return x; }, parlay::fl_low_memory);
+    ASSERT_EQ(s, sorted);
+  }
+}
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemoryUniquePtr) {
+  auto s = parlay::tabulate(100000, [](long long int i) {
+    return std::make_unique<long long int>((50021 * i + 61) % (1 << 20));
+  });
+  parlay::integer_sort_inplace(s, [](const auto& p) { return static_cast<unsigned int>(*p); },
+                               parlay::fl_low_memory);
+  ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s), [](const auto& p1, const auto& p2) {
+    return *p1 < *p2;
+  }));
+}
+
+TEST(TestIntegerSort, TestIntegerSortInplaceLowMemoryNonContiguous) {
+  auto ss = parlay::tabulate(300000, [](unsigned long long i) {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto s = std::deque<unsigned long long>(ss.begin(), ss.end());
+  auto s2 = s;
+  parlay::integer_sort_inplace(s, [](auto x) { return x; }, parlay::fl_low_memory);
+  std::sort(std::begin(s2), std::end(s2));
+  ASSERT_EQ(s, s2);
+}
+
+TEST(TestIntegerSort, TestIntegerSortSignedKeys) {
+  auto s = parlay::tabulate(300000, [](long long i) -> long long {
+    return static_cast<long long>(parlay::hash64(i));
+  });
+  auto sorted = s;
+  std::sort(std::begin(sorted), std::end(sorted));
+  ASSERT_EQ(parlay::integer_sort(s), sorted);
+  parlay::integer_sort_inplace(s, [](auto x) { return x; }, parlay::fl_low_memory);
+  ASSERT_EQ(s, sorted);
+}
+
+TEST(TestIntegerSort, TestIntegerSortDoubleKeys) {
+  auto s = parlay::tabulate(300000, [](int i) -> std::pair<double, int> {
+    return {(static_cast<double>(parlay::hash64(i) % 1000000) - 500000) / 3, i};
+  });
+  auto sorted = s;
+  std::stable_sort(std::begin(sorted), std::end(sorted), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+  auto by_first = [](const auto& p) { return p.first; };
+  ASSERT_EQ(parlay::integer_sort(s, by_first), sorted);
+  auto s2 = s;
+  parlay::integer_sort_inplace(s2, by_first);
+  ASSERT_EQ(s2, sorted);
+  parlay::integer_sort_inplace(s, by_first, parlay::fl_low_memory);
+  ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  }));
+}
+
+TEST(TestIntegerSort, TestIntegerSortFloats) {
+  auto s = parlay::tabulate(300000, [](int i) -> float {
+    return (static_cast<float>(parlay::hash64(i) % 100000) - 50000) / 7;
+  });
+  s[0] = -0.0f;
+  s[1] = std::numeric_limits<float>::infinity();
+  s[2] = std::numeric_limits<float>::quiet_NaN();
+  auto sorted = parlay::integer_sort(s);
+  ASSERT_TRUE(std::isnan(sorted[sorted.size() - 1]));
+  ASSERT_EQ(sorted[sorted.size() - 2], std::numeric_limits<float>::infinity());
+  ASSERT_TRUE(std::is_sorted(std::begin(sorted), std::end(sorted) - 1));
+}
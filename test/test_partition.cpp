@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <deque>
+#include <string>
+
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+#include "sorting_utils.h"
+
+// Checks that s is a rearrangement of original that is partitioned by f
+// at position k
+template<typename Seq, typename UnaryPred>
+void check_partition(const Seq& s, const Seq& original, size_t k, UnaryPred f) {
+  ASSERT_EQ(s.size(), original.size());
+  for (size_t i = 0; i < k; i++) ASSERT_TRUE(f(s[i]));
+  for (size_t i = k; i < s.size(); i++) ASSERT_FALSE(f(s[i]));
+  auto sorted = parlay::sort(s);
+  ASSERT_EQ(sorted, parlay::sort(original));
+}
+
+TEST(TestPartition, TestSimple) {
+  auto s = parlay::tabulate(1000000, [](long i) -> long { return parlay::hash64(i) % 1000000; });
+  for (long threshold : {0L, 1L, 1000L, 500000L, 999999L, 1000000L}) {
+    auto s2 = s;
+    auto f = [&](long x) { return x < threshold; };
+    auto it = parlay::partition(s2, f);
+    check_partition(s2, s, it - s2.begin(), f);
+  }
+}
+
+TEST(TestPartition, TestSizes) {
+  for (size_t n : {0, 1, 2, 1000, 16383, 16384, 16385, 50000, 100001}) {
+    auto s = parlay::tabulate(n, [](size_t i) -> int { return parlay::hash64(i) % 100; });
+    auto s2 = s;
+    auto f = [](int x) { return x % 3 == 0; };
+    auto it = parlay::partition(s2, f);
+    check_partition(s2, s, it - s2.begin(), f);
+  }
+}
+
+TEST(TestPartition, TestSkewed) {
+  // Few misplaced elements, far apart
+  size_t n = 1000000;
+  auto s = parlay::tabulate(n, [&](size_t i) -> int { return i < n / 2; });
+  s[10] = 0;
+  s[n / 2 - 1] = 0;
+  s[n / 2 + 3] = 1;
+  s[n - 1] = 1;
+  auto s2 = s;
+  auto f = [](int x) { return x == 1; };
+  auto it = parlay::partition(s2, f);
+  check_partition(s2, s, it - s2.begin(), f);
+  ASSERT_EQ(it - s2.begin(), n / 2);
+}
+
+TEST(TestPartition, TestStrings) {
+  auto s = parlay::tabulate(200000, [](size_t i) { return std::to_string(parlay::hash64(i) % 100000); });
+  auto s2 = s;
+  auto f = [](const std::string& x) { return x.back() < '4'; };
+  auto it = parlay::partition(s2, f);
+  check_partition(s2, s, it - s2.begin(), f);
+}
+
+TEST(TestPartition, TestUncopyable) {
+  size_t n = 200000;
+  auto s = parlay::tabulate(n, [](size_t i) { return UncopyableThing(parlay::hash64(i) % 1000); });
+  auto f = [](const UncopyableThing& x) { return x.x % 2 == 0; };
+  auto it = parlay::partition(s, f);
+  size_t k = it - s.begin();
+  for (size_t i = 0; i < k; i++) ASSERT_TRUE(f(s[i]));
+  for (size_t i = k; i < n; i++) ASSERT_FALSE(f(s[i]));
+  size_t expected = 0;
+  for (size_t i = 0; i < n; i++) expected += (parlay::hash64(i) % 1000) % 2 == 0;
+  ASSERT_EQ(k, expected);
+}
+
+TEST(TestPartition, TestNonContiguous) {
+  auto s = parlay::tabulate(100000, [](long i) -> long { return parlay::hash64(i) % 1000; });
+  std::deque<long> d(s.begin(), s.end());
+  auto f = [](long x) { return x < 300; };
+  auto it = parlay::partition(d, f);
+  auto result = parlay::to_sequence(d);
+  check_partition(result, s, it - d.begin(), f);
+}
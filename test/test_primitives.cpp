@@ -1,8 +1,14 @@
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <cmath>
+#include <atomic>
 #include <deque>
+#include <limits>
 #include <numeric>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 #include <parlay/monoid.h>
 #include <parlay/primitives.h>
@@ -61,6 +67,88 @@ TEST(TestPrimitives, TestCopy) {
   ASSERT_EQ(s, s2);
 }
 
+TEST(TestPrimitives, TestParallelForNested) {
+  // Power-law row sizes, with many empty rows and a few huge ones
+  size_t n = 20000;
+  auto sizes = parlay::tabulate(n, [n](size_t i) -> size_t {
+    return (i % 3 == 0) ? 0 : 500000 / ((i * 7919) % n + 1);
+  });
+  auto offsets = parlay::tabulate(n + 1, [&](size_t i) { return i < n ? sizes[i] : size_t{0}; });
+  size_t total = parlay::scan_inplace(offsets);
+  auto visits = parlay::sequence<std::atomic<int>>(total);
+  for (size_t granularity : {size_t{0}, size_t{1}, size_t{100}, size_t{1} << 20}) {
+    parlay::parallel_for(0, total, [&](size_t k) { visits[k].store(0); });
+    parlay::parallel_for_nested(offsets, [&](size_t i, size_t s, size_t e) {
+      ASSERT_LT(i, n);
+      ASSERT_LT(s, e);
+      ASSERT_LE(e, sizes[i]);
+      for (size_t j = s; j < e; j++) visits[offsets[i] + j]++;
+    }, granularity);
+    for (size_t k = 0; k < total; k++) {
+      ASSERT_EQ(visits[k].load(), 1);
+    }
+  }
+}
+
+TEST(TestPrimitives, TestParallelForNestedEmpty) {
+  auto offsets = parlay::sequence<size_t>(1000, 42);
+  parlay::parallel_for_nested(offsets, [&](size_t, size_t, size_t) { FAIL(); });
+  parlay::parallel_for_nested(parlay::sequence<size_t>(1, 0), [&](size_t, size_t, size_t) { FAIL(); });
+}
+
+TEST(TestPrimitives, TestFlattenSkewed) {
+  size_t n = 5000;
+  auto seqs = parlay::tabulate(n, [&](size_t i) {
+    size_t len = (i % 2 == 0) ? 0 : (i == 1 ? 300000 : i % 17);
+    return parlay::tabulate(len, [i](size_t j) { return std::to_string(i) + "," + std::to_string(j); });
+  });
+  auto flat = parlay::flatten(seqs);
+  std::vector<std::string> expected;
+  for (const auto& s : seqs) expected.insert(expected.end(), s.begin(), s.end());
+  ASSERT_EQ(flat, parlay::to_sequence(expected));
+}
+
+TEST(TestPrimitives, TestCopyNonTrivial) {
+  auto s = parlay::tabulate(100000, [](size_t i) { return std::to_string(i); });
+  auto s2 = parlay::sequence<std::string>(100000);
+  parlay::copy(s, s2);
+  ASSERT_EQ(s, s2);
+  auto d = parlay::delayed_seq<long long>(100000, [](size_t i) -> long long { return 7 * i; });
+  auto s3 = parlay::sequence<long long>(100000);
+  parlay::copy(d, s3);
+  for (size_t i = 0; i < 100000; i++) {
+    ASSERT_EQ(s3[i], 7 * i);
+  }
+}
+
+TEST(TestPrimitives, TestAppendRotateReverse) {
+  auto a = parlay::tabulate(150000, [](long long i) -> long long { return i; });
+  auto b = parlay::tabulate(70001, [](long long i) -> long long { return -i; });
+  auto ab = parlay::append(a, b);
+  std::vector<long long> expected(a.begin(), a.end());
+  expected.insert(expected.end(), b.begin(), b.end());
+  ASSERT_EQ(ab, parlay::to_sequence(expected));
+
+  auto r = parlay::rotate(ab, 12345);
+  std::rotate(expected.begin(), expected.end() - 12345, expected.end());
+  ASSERT_EQ(r, parlay::to_sequence(expected));
+
+  auto rev = parlay::reverse(r);
+  std::reverse(expected.begin(), expected.end());
+  ASSERT_EQ(rev, parlay::to_sequence(expected));
+
+  auto sa = parlay::map(a, [](long long x) { return std::to_string(x); });
+  auto sb = parlay::map(b, [](long long x) { return std::to_string(x); });
+  auto sab = parlay::append(sa, sb);
+  ASSERT_EQ(sab.size(), sa.size() + sb.size());
+  ASSERT_EQ(sab[0], "0");
+  ASSERT_EQ(sab[sa.size()], "0");
+  ASSERT_EQ(sab.back(), "-70000");
+  auto sr = parlay::rotate(sab, 1);
+  ASSERT_EQ(sr[0], "-70000");
+  ASSERT_EQ(sr[1], "0");
+}
+
 TEST(TestPrimitives, TestReduce) {
   auto s = parlay::tabulate(100000, [](long long i) -> long long {
     return (50021 * i + 61) % (1 << 20);
@@ -174,6 +262,172 @@ TEST(TestPrimitives, TestScanInclusiveInplaceMax) {
   ASSERT_EQ(total, sum);
 }
 
+// Checks reduce and the four scans against a left-to-right loop for
+// sizes that are not multiples of the vector width
+template<typename T, typename Monoid>
+void check_reduce_and_scan(Monoid m) {
+  for (size_t n : {0, 1, 7, 33, 1000, 2049, 100003}) {
+    auto s = parlay::tabulate(n, [](size_t i) -> T {
+      return static_cast<T>(parlay::hash64(i) % 1000) - static_cast<T>(std::is_signed_v<T> ? 500 : 0);
+    });
+    auto psums = parlay::sequence<T>(n);
+    auto ipsums = parlay::sequence<T>(n);
+    T total = m.identity;
+    for (size_t i = 0; i < n; i++) {
+      psums[i] = total;
+      total = m.f(total, s[i]);
+      ipsums[i] = total;
+    }
+    ASSERT_EQ(parlay::reduce(s, m), total);
+    auto [scanz, scan_total] = parlay::scan(s, m);
+    ASSERT_EQ(scanz, psums);
+    ASSERT_EQ(scan_total, total);
+    ASSERT_EQ(parlay::scan_inclusive(s, m), ipsums);
+    auto s2 = s;
+    ASSERT_EQ(parlay::scan_inplace(s2, m), total);
+    ASSERT_EQ(s2, psums);
+    ASSERT_EQ(parlay::scan_inclusive_inplace(s, m), total);
+    ASSERT_EQ(s, ipsums);
+  }
+}
+
+TEST(TestPrimitives, TestReduceScanArithmeticMonoids) {
+  check_reduce_and_scan<int>(parlay::addm<int>());
+  check_reduce_and_scan<int>(parlay::maxm<int>());
+  check_reduce_and_scan<int>(parlay::minm<int>());
+  check_reduce_and_scan<unsigned long>(parlay::xorm<unsigned long>());
+  check_reduce_and_scan<unsigned char>(parlay::addm<unsigned char>());
+  check_reduce_and_scan<short>(parlay::maxm<short>());
+  check_reduce_and_scan<float>(parlay::minm<float>());
+  check_reduce_and_scan<double>(parlay::maxm<double>());
+  // Small integers are represented exactly, so the sums do not depend on the order
+  check_reduce_and_scan<double>(parlay::addm<double>());
+}
+
+TEST(TestPrimitives, TestScanNonCommutative) {
+  // Composition of affine maps x -> a*x + b modulo 2^64 is associative
+  // but not commutative, so it checks the order of the combined blocks
+  using affine = std::pair<unsigned long, unsigned long>;
+  auto m = parlay::make_monoid([](affine f, affine g) {
+    return affine{g.first * f.first, g.first * f.second + g.second}; }, affine{1, 0});
+  auto s = parlay::tabulate(1000000, [](size_t i) -> affine {
+    return {2 * parlay::hash64(i) + 1, parlay::hash64(i + 1)}; });
+  auto [scanz, total] = parlay::scan(s, m);
+  affine r = m.identity;
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(scanz[i], r);
+    r = m.f(r, s[i]);
+  }
+  ASSERT_EQ(total, r);
+}
+
+TEST(TestPrimitives, TestScanFloatDeterministic) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> double {
+    return 1.0 / (1 + parlay::hash64(i) % 1000); });
+  auto [first, first_total] = parlay::scan(s);
+  for (int r = 0; r < 5; r++) {
+    auto [again, again_total] = parlay::scan(s);
+    ASSERT_EQ(first, again);
+    ASSERT_EQ(first_total, again_total);
+  }
+}
+
+TEST(TestPrimitives, TestScanForkingElements) {
+  // Reading each element runs a parallel reduce, so the scan must not
+  // wait on blocks that may be suspended under the waiting task
+  size_t n = 10000;
+  auto s = parlay::delayed_tabulate(n, [](size_t i) -> long {
+    return parlay::reduce(parlay::delayed_tabulate(5000, [i](size_t j) -> long { return (i + j) % 3; })); });
+  auto [scanz, total] = parlay::scan(s);
+  long r = 0;
+  for (size_t i = 0; i < n; i++) {
+    ASSERT_EQ(scanz[i], r);
+    r += s[i];
+  }
+  ASSERT_EQ(total, r);
+}
+
+TEST(TestPrimitives, TestNestedScans) {
+  auto seqs = parlay::tabulate(32, [](size_t i) {
+    return parlay::tabulate(100000 + i, [i](size_t j) -> long { return (i * j) % 7; }); });
+  auto totals = parlay::tabulate(32, [&](size_t i) {
+    return parlay::scan_inplace(seqs[i]); });
+  for (size_t i = 0; i < 32; i++) {
+    long r = 0;
+    for (size_t j = 0; j < seqs[i].size(); j++) {
+      ASSERT_EQ(seqs[i][j], r);
+      r += static_cast<long>((i * j) % 7);
+    }
+    ASSERT_EQ(totals[i], r);
+  }
+}
+
+// A value that counts how many times it is copied
+struct CountedCopies {
+  static inline std::atomic<size_t> copies{0};
+  std::string s;
+  CountedCopies() = default;
+  CountedCopies(std::string s_) : s(std::move(s_)) {}
+  CountedCopies(const CountedCopies& other) : s(other.s) { copies++; }
+  CountedCopies(CountedCopies&&) = default;
+  CountedCopies& operator=(const CountedCopies& other) { s = other.s; copies++; return *this; }
+  CountedCopies& operator=(CountedCopies&&) = default;
+};
+
+// Concatenation, which appends to the accumulator in place
+struct concat_monoid {
+  using T = CountedCopies;
+  T identity;
+  static T f(const T& a, const T& b) { return T(a.s + b.s); }
+  static void combine_into(T& acc, const T& x) { acc.s += x.s; }
+};
+
+TEST(TestPrimitives, TestReduceCombineInto) {
+  size_t n = 100000;
+  auto s = parlay::tabulate(n, [](size_t i) { return CountedCopies(std::to_string(i % 10)); });
+  std::string expected;
+  for (size_t i = 0; i < n; i++) expected += s[i].s;
+  CountedCopies::copies = 0;
+  auto r = parlay::reduce(s, concat_monoid());
+  ASSERT_EQ(r.s, expected);
+  // One copy per block to start its accumulator, rather than one per element
+  ASSERT_LT(CountedCopies::copies.load(), n / 100);
+}
+
+TEST(TestPrimitives, TestScanCombineInto) {
+  size_t n = 20000;
+  auto s = parlay::tabulate(n, [](size_t i) { return CountedCopies(std::string(1, 'a' + i % 26)); });
+  auto [scanz, total] = parlay::scan(s, concat_monoid());
+  auto inclusive = parlay::scan_inclusive(s, concat_monoid());
+  std::string r;
+  for (size_t i = 0; i < n; i++) {
+    ASSERT_EQ(scanz[i].s, r);
+    r += s[i].s;
+    ASSERT_EQ(inclusive[i].s, r);
+  }
+  ASSERT_EQ(total.s, r);
+}
+
+TEST(TestPrimitives, TestReduceRvalueMonoid) {
+  // An f that takes the accumulator by value can append to it
+  auto m = parlay::make_monoid([](parlay::sequence<int> a, const parlay::sequence<int>& b) {
+    a.append(b);
+    return a;
+  }, parlay::sequence<int>());
+  auto s = parlay::tabulate(50000, [](int i) { return parlay::sequence<int>(i % 3, i); });
+  auto r = parlay::reduce(s, m);
+  auto expected = parlay::flatten(s);
+  ASSERT_EQ(r, expected);
+}
+
+TEST(TestPrimitives, TestGroupByAndCombineInto) {
+  auto s = parlay::tabulate(100000, [](size_t i) {
+    return std::make_pair(i % 10, CountedCopies(std::string(1, 'a' + i % 7))); });
+  auto r = parlay::internal::group_by_and_combine(s, concat_monoid());
+  ASSERT_EQ(r.size(), 10);
+  for (auto& [k, v] : r) ASSERT_EQ(v.s.size(), 10000);
+}
+
 TEST(TestPrimitives, TestPack) {
   auto s = parlay::tabulate(100000, [](int i) { return i; });
   auto b = parlay::tabulate(100000, [](int i) -> bool { return i % 2 == 0; });
@@ -206,6 +460,22 @@ TEST(TestPrimitives, TestPackInto) {
   }
 }
 
+TEST(TestPrimitives, TestPackIntoLeavesRestUntouched) {
+  for (size_t n : {5, 100, 5000, 100000}) {
+    auto s = parlay::tabulate(n, [](size_t i) -> int { return static_cast<int>(i + 1); });
+    auto b = parlay::tabulate(n, [](size_t i) -> bool { return i % 7 == 0; });
+    auto d = parlay::sequence<int>(n, 9);
+    size_t m = parlay::pack_into(s, b, d);
+    ASSERT_EQ(m, (n + 6) / 7);
+    for (size_t i = 0; i < m; i++) {
+      ASSERT_EQ(d[i], 7 * i + 1);
+    }
+    for (size_t i = m; i < n; i++) {
+      ASSERT_EQ(d[i], 9);
+    }
+  }
+}
+
 TEST(TestPrimitives, TestPackIntoConvertible) {
   auto s = parlay::tabulate(100000, [](int i) { return i; });
   auto d = parlay::sequence<int>(50000);
@@ -256,6 +526,115 @@ TEST(TestPrimitives, TestFilterInto) {
   }
 }
 
+TEST(TestPrimitives, TestFilterStrings) {
+  auto s = parlay::tabulate(100000, [](size_t i) { return std::to_string(i); });
+  auto f = parlay::filter(s, [](const std::string& x) { return x.back() == '7'; });
+  ASSERT_EQ(f.size(), 10000);
+  for (size_t i = 0; i < 10000; i++) {
+    ASSERT_EQ(f[i], std::to_string(10 * i + 7));
+  }
+}
+
+TEST(TestPrimitives, TestFilterLargeElements) {
+  // Elements too large to buffer a block of them on the stack
+  struct big { size_t key; char payload[120]; };
+  auto s = parlay::tabulate(100000, [](size_t i) { big b{}; b.key = i; return b; });
+  auto f = parlay::filter(s, [](const big& x) { return x.key % 3 == 0; });
+  ASSERT_EQ(f.size(), 33334);
+  for (size_t i = 0; i < 33334; i++) {
+    ASSERT_EQ(f[i].key, 3*i);
+  }
+}
+
+TEST(TestPrimitives, TestFilterSkewed) {
+  // Whole blocks pass or fail together
+  auto s = parlay::tabulate(1000000, [](size_t i) { return i; });
+  auto f = parlay::filter(s, [](size_t x) { return (x / 5000) % 2 == 1; });
+  auto expected = parlay::tabulate(500000, [](size_t i) { return 5000 * (2 * (i / 5000) + 1) + i % 5000; });
+  ASSERT_EQ(f, expected);
+  ASSERT_TRUE(parlay::filter(s, [](size_t) { return false; }).empty());
+  ASSERT_EQ(parlay::filter(s, [](size_t) { return true; }), s);
+}
+
+TEST(TestPrimitives, TestFilterIntoStrings) {
+  auto s = parlay::tabulate(100000, [](size_t i) { return std::to_string(i); });
+  auto d = parlay::sequence<std::string>(10000);
+  auto f = parlay::filter_into(s, d, [](const std::string& x) { return x.back() == '3'; });
+  ASSERT_EQ(f, 10000);
+  for (size_t i = 0; i < 10000; i++) {
+    ASSERT_EQ(d[i], std::to_string(10 * i + 3));
+  }
+}
+
+template<typename T>
+void check_pack_kernel() {
+  for (size_t n : {0, 1, 7, 8, 15, 16, 17, 1000, 1024, 1025, 100000}) {
+    for (size_t every : {1, 2, 3, 50}) {
+      auto s = parlay::tabulate(n, [](size_t i) -> T { return static_cast<T>(i); });
+      auto b = parlay::tabulate(n, [&](size_t i) -> bool { return parlay::hash64(i) % every == 0; });
+      auto expected = parlay::sequence<T>();
+      for (size_t i = 0; i < n; i++) {
+        if (b[i]) expected.push_back(s[i]);
+      }
+      ASSERT_EQ(parlay::pack(s, b), expected);
+      auto out = parlay::sequence<T>(expected.size());
+      ASSERT_EQ(parlay::pack_into(s, b, out), expected.size());
+      ASSERT_EQ(out, expected);
+      auto f = parlay::filter(s, [&](T x) { return b[static_cast<size_t>(x)]; });
+      ASSERT_EQ(f, expected);
+      auto idx = parlay::pack_index<T>(b);
+      ASSERT_EQ(idx, expected);
+    }
+  }
+}
+
+TEST(TestPrimitives, TestPackKernelTypes) {
+  check_pack_kernel<int32_t>();
+  check_pack_kernel<uint32_t>();
+  check_pack_kernel<int64_t>();
+  check_pack_kernel<uint64_t>();
+  check_pack_kernel<float>();
+  check_pack_kernel<double>();
+}
+
+TEST(TestPrimitives, TestUnorderedFilter) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> long { return parlay::hash64(i) % 1000; });
+  for (long threshold : {0L, 10L, 500L, 999L, 1000L}) {
+    auto f = parlay::unordered_filter(s, [&](long x) { return x < threshold; });
+    auto expected = parlay::filter(s, [&](long x) { return x < threshold; });
+    ASSERT_EQ(parlay::sort(f), parlay::sort(expected));
+  }
+}
+
+TEST(TestPrimitives, TestUnorderedFilterStrings) {
+  auto s = parlay::tabulate(100000, [](size_t i) { return std::to_string(i); });
+  auto f = parlay::unordered_filter(s, [](const std::string& x) { return x.back() == '7'; });
+  auto expected = parlay::filter(s, [](const std::string& x) { return x.back() == '7'; });
+  ASSERT_EQ(parlay::sort(f), parlay::sort(expected));
+}
+
+TEST(TestPrimitives, TestUnorderedFilterInto) {
+  auto s = parlay::tabulate(100000, [](int i) { return i; });
+  auto d = parlay::sequence<int>(33334);
+  auto m = parlay::unordered_filter_into(s, d, [](int x) { return x % 3 == 0; });
+  ASSERT_EQ(m, 33334);
+  std::sort(d.begin(), d.end());
+  for (size_t i = 0; i < 33334; i++) {
+    ASSERT_EQ(d[i], 3*i);
+  }
+}
+
+TEST(TestPrimitives, TestPackUnordered) {
+  auto s = parlay::tabulate(100000, [](size_t i) { return i; });
+  auto b = parlay::tabulate(100000, [](size_t i) -> bool { return parlay::hash64(i) % 5 == 0; });
+  auto p = parlay::pack_unordered(s, b);
+  ASSERT_EQ(parlay::sort(p), parlay::pack(s, b));
+  auto d = parlay::sequence<size_t>(p.size());
+  ASSERT_EQ(parlay::pack_unordered_into(s, b, d), p.size());
+  ASSERT_EQ(parlay::sort(d), parlay::pack(s, b));
+  ASSERT_TRUE(parlay::pack_unordered(parlay::sequence<int>(), parlay::sequence<bool>()).empty());
+}
+
 TEST(TestPrimitives, TestHistogram) {
   auto s = parlay::tabulate(100000, [](long long i) -> long long {
     return (50021 * i + 61) % (1 << 20);
@@ -427,6 +806,128 @@ TEST(TestPrimitives, TestStableSortInplaceNonContiguous) {
   ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
 }
 
+TEST(TestPrimitives, TestSortSignedIntegers) {
+  auto s = parlay::tabulate(100000, [](long long i) -> long long {
+    return (i % 2 == 0 ? -1 : 1) * static_cast<long long>(parlay::hash64(i) >> 2);
+  });
+  s[0] = std::numeric_limits<long long>::min();
+  s[1] = std::numeric_limits<long long>::max();
+  auto sorted = parlay::sort(s);
+  std::sort(std::begin(s), std::end(s));
+  ASSERT_EQ(s, sorted);
+}
+
+TEST(TestPrimitives, TestSortSmallIntegers) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> signed char {
+    return static_cast<signed char>(parlay::hash64(i));
+  });
+  auto s2 = s;
+  parlay::sort_inplace(s);
+  std::sort(std::begin(s2), std::end(s2));
+  ASSERT_EQ(s, s2);
+}
+
+TEST(TestPrimitives, TestSortIntegersFullRange) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> uint64_t { return parlay::hash64(i); });
+  s[0] = 0;
+  s[1] = std::numeric_limits<uint64_t>::max();
+  auto sorted = parlay::sort(s, std::less<>());
+  std::sort(std::begin(s), std::end(s));
+  ASSERT_EQ(s, sorted);
+}
+
+TEST(TestPrimitives, TestSortIntegersNarrowRange) {
+  auto s = parlay::tabulate(100000, [](size_t i) -> unsigned int {
+    return 4000000000u + parlay::hash64(i) % 1000;
+  });
+  auto sorted = parlay::stable_sort(s);
+  std::sort(std::begin(s), std::end(s));
+  ASSERT_EQ(s, sorted);
+  auto same = parlay::sequence<int>(1000, 42);
+  ASSERT_EQ(parlay::sort(same), same);
+  ASSERT_TRUE(parlay::sort(parlay::sequence<int>()).empty());
+}
+
+TEST(TestPrimitives, TestSortByKey) {
+  auto s = parlay::tabulate(100000, [](long long i) -> std::pair<int, long long> {
+    return {static_cast<int>(parlay::hash64(i) % 2000) - 1000, i};
+  });
+  auto by_first = [](const auto& p) { return p.first; };
+  auto sorted = parlay::sort_by_key(s, by_first);
+  ASSERT_EQ(sorted.size(), s.size());
+  ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first; }));
+  auto s2 = s;
+  std::sort(s2.begin(), s2.end());
+  ASSERT_EQ(parlay::sort(sorted), s2);
+
+  parlay::sort_by_key_inplace(s, [](const auto& p) { return static_cast<double>(p.second) / 3; });
+  ASSERT_TRUE(std::is_sorted(s.begin(), s.end(), [](const auto& a, const auto& b) {
+    return a.second < b.second; }));
+}
+
+TEST(TestPrimitives, TestSortDoubles) {
+  auto s = parlay::tabulate(200000, [](long long i) -> double {
+    return (static_cast<double>(parlay::hash64(i) % 2000000) - 1000000) / 7;
+  });
+  s[0] = std::numeric_limits<double>::infinity();
+  s[1] = -std::numeric_limits<double>::infinity();
+  s[2] = std::numeric_limits<double>::denorm_min();
+  s[3] = -std::numeric_limits<double>::denorm_min();
+  s[4] = (std::numeric_limits<double>::max)();
+  s[5] = std::numeric_limits<double>::lowest();
+  auto s2 = s;
+  std::sort(s2.begin(), s2.end());
+  ASSERT_EQ(parlay::sort(s), s2);
+  ASSERT_EQ(parlay::stable_sort(s), s2);
+  auto s3 = s;
+  parlay::sort_inplace(s3);
+  ASSERT_EQ(s3, s2);
+  auto s4 = s;
+  parlay::stable_sort_inplace(s4);
+  ASSERT_EQ(s4, s2);
+}
+
+TEST(TestPrimitives, TestSortFloats) {
+  auto s = parlay::tabulate(200000, [](long long i) -> float {
+    return (static_cast<float>(parlay::hash64(i) % 20000) - 10000) / 3;
+  });
+  auto s2 = s;
+  std::sort(s2.begin(), s2.end());
+  ASSERT_EQ(parlay::sort(s), s2);
+  parlay::sort_inplace(s);
+  ASSERT_EQ(s, s2);
+}
+
+TEST(TestPrimitives, TestStableSortSignedZeros) {
+  auto s = parlay::tabulate(200000, [](long long i) -> double {
+    return (parlay::hash64(i) % 2 == 0) ? 0.0 : -0.0;
+  });
+  auto s2 = s;
+  std::stable_sort(s2.begin(), s2.end());
+  auto sorted = parlay::stable_sort(s);
+  parlay::stable_sort_inplace(s);
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(std::signbit(sorted[i]), std::signbit(s2[i]));
+    ASSERT_EQ(std::signbit(s[i]), std::signbit(s2[i]));
+  }
+}
+
+TEST(TestPrimitives, TestSortDoublesNaN) {
+  auto s = parlay::tabulate(200000, [](long long i) -> double {
+    if (i % 10 == 0) return std::numeric_limits<double>::quiet_NaN();
+    if (i % 10 == 1) return -std::numeric_limits<double>::quiet_NaN();
+    return static_cast<double>(parlay::hash64(i) % 1000) - 500;
+  });
+  auto sorted = parlay::sort(s);
+  size_t num_nans = 40000;
+  size_t n = s.size();
+  ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.begin() + (n - num_nans)));
+  for (size_t i = n - num_nans; i < n; i++) {
+    ASSERT_TRUE(std::isnan(sorted[i]));
+  }
+}
+
 TEST(TestPrimitives, TestIntegerSort) {
   auto s = parlay::tabulate(100000, [](unsigned long long i) -> unsigned long long {
     return (50021 * i + 61) % (1 << 20);
@@ -524,6 +1025,45 @@ TEST(TestPrimitives, TestFlatten) {
   ASSERT_EQ(seq, answer);
 }
 
+// The distinct elements in order of first occurrence, computed sequentially
+template<typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<T>>
+parlay::sequence<T> first_occurrences(const parlay::sequence<T>& s, Hash hash = {}, Equal eq = {}) {
+  std::unordered_set<T, Hash, Equal> seen(1, hash, eq);
+  parlay::sequence<T> result;
+  for (const auto& x : s) {
+    if (seen.insert(x).second) result.push_back(x);
+  }
+  return result;
+}
+
+TEST(TestPrimitives, TestRemoveDuplicates) {
+  for (size_t distinct : {1, 10, 1000, 100000}) {
+    auto s = parlay::tabulate(300000, [&](size_t i) -> long { return parlay::hash64(i) % distinct; });
+    ASSERT_EQ(parlay::remove_duplicates(s), first_occurrences(s));
+  }
+}
+
+TEST(TestPrimitives, TestRemoveDuplicatesAllDistinct) {
+  auto s = parlay::tabulate(200000, [](size_t i) -> unsigned int { return 1024 * i; });
+  ASSERT_EQ(parlay::remove_duplicates(s), s);
+  ASSERT_TRUE(parlay::remove_duplicates(parlay::sequence<int>()).empty());
+}
+
+TEST(TestPrimitives, TestRemoveDuplicatesStrings) {
+  auto s = parlay::tabulate(100000, [](size_t i) { return std::to_string(parlay::hash64(i) % 5000); });
+  ASSERT_EQ(parlay::remove_duplicates(s), first_occurrences(s));
+}
+
+TEST(TestPrimitives, TestRemoveDuplicatesCustomEquality) {
+  // Elements are equal if they are equal modulo 100
+  auto hash = [](long x) { return std::hash<long>()(x % 100); };
+  auto eq = [](long a, long b) { return a % 100 == b % 100; };
+  auto s = parlay::tabulate(100000, [](size_t i) -> long { return parlay::hash64(i) % 100000; });
+  auto r = parlay::remove_duplicates(s, hash, eq);
+  ASSERT_EQ(r.size(), 100);
+  ASSERT_EQ(r, first_occurrences(s, hash, eq));
+}
+
 TEST(TestPrimitives, TestTokens) {
   auto chars = parlay::to_sequence(std::string(" The quick\tbrown fox jumped over  the lazy\ndog "));
   auto words = parlay::sequence<parlay::sequence<char>> {
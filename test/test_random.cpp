@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
+
 #include <parlay/primitives.h>
 #include <parlay/random.h>
 #include <parlay/sequence.h>
@@ -27,6 +29,28 @@ TEST(TestRandom, TestRandomShuffle) {
   ASSERT_EQ(s, s2);
 }
 
+TEST(TestRandom, TestRandomShuffleSmall) {
+  // Small inputs are Knuth shuffled, with step i drawing ith_rand_hash(i)
+  parlay::random r(5);
+  for (size_t n : {size_t{0}, size_t{1}, size_t{2}, size_t{3}, size_t{512}, size_t{513}, size_t{5000}}) {
+    auto s = parlay::tabulate(n, [](size_t i) { return i; });
+    auto expected = s;
+    for (size_t i = n; i-- > 1;) std::swap(expected[i], expected[r.ith_rand_hash(i) % (i + 1)]);
+    ASSERT_EQ(parlay::random_shuffle(s, r), expected);
+  }
+}
+
+TEST(TestRandom, TestMaskedRandomBits) {
+  parlay::random r(9);
+  for (auto [s, e] : {std::pair<size_t, size_t>{0, 0}, {3, 4}, {3, 10}, {7, 10000}, {8, 10001}}) {
+    auto bits = parlay::internal::masked_random_bits<uint32_t>(r, s, e, 1023);
+    ASSERT_EQ(bits.size(), e - s);
+    for (size_t i = s; i < e; i++) {
+      ASSERT_EQ(bits[i - s], r.ith_rand(i) & 1023);
+    }
+  }
+}
+
 TEST(TestRandom, TestRandomPermutation) {
   auto p = parlay::random_permutation<int>(100000);
   auto s = parlay::tabulate(100000, [](int i) -> int {
@@ -35,3 +59,268 @@ TEST(TestRandom, TestRandomPermutation) {
   std::sort(p.begin(), p.end());
   ASSERT_EQ(p, s);
 }
+
+// Known answers from the Random123 distribution
+TEST(TestRandom, TestPhiloxKnownAnswers) {
+  uint32_t c1[4] = {0, 0, 0, 0};
+  parlay::internal::philox4x32(c1, 0, 0);
+  ASSERT_EQ(c1[0], 0x6627e8d5u);
+  ASSERT_EQ(c1[1], 0xe169c58du);
+  ASSERT_EQ(c1[2], 0xbc57ac4cu);
+  ASSERT_EQ(c1[3], 0x9b00dbd8u);
+  uint32_t c2[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+  parlay::internal::philox4x32(c2, 0xffffffff, 0xffffffff);
+  ASSERT_EQ(c2[0], 0x408f276du);
+  ASSERT_EQ(c2[1], 0x41c83b0eu);
+  ASSERT_EQ(c2[2], 0xa20bc7c6u);
+  ASSERT_EQ(c2[3], 0x6d5451fdu);
+  uint32_t c3[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+  parlay::internal::philox4x32(c3, 0xa4093822, 0x299f31d0);
+  ASSERT_EQ(c3[0], 0xd16cfe09u);
+  ASSERT_EQ(c3[1], 0x94fdccebu);
+  ASSERT_EQ(c3[2], 0x5001e420u);
+  ASSERT_EQ(c3[3], 0x24126ea1u);
+}
+
+TEST(TestRandom, TestRandomBits) {
+  parlay::random r(42);
+  for (size_t n : {size_t{0}, size_t{1}, size_t{17}, size_t{100001}}) {
+    auto bits = parlay::random_bits(n, r);
+    ASSERT_EQ(bits.size(), n);
+    for (size_t i = 0; i < n; i++) {
+      ASSERT_EQ(bits[i], r.ith_rand(i));
+    }
+  }
+  // Different seeds and forks give different numbers
+  ASSERT_NE(parlay::random(1).ith_rand(0), parlay::random(2).ith_rand(0));
+  ASSERT_NE(r.fork(1).ith_rand(0), r.fork(2).ith_rand(0));
+  // The bits are close to balanced
+  auto bits = parlay::random_bits(100000, r);
+  auto ones = parlay::reduce(parlay::map(bits, [](uint64_t x) -> size_t { return __builtin_popcountll(x); }));
+  ASSERT_NEAR(static_cast<double>(ones) / (64 * 100000), 0.5, 0.001);
+}
+
+template <typename Distribution>
+void check_samples(const parlay::sequence<typename Distribution::result_type>& s,
+                   const Distribution& dist, parlay::random r) {
+  for (size_t i = 0; i < s.size(); i++) {
+    ASSERT_EQ(s[i], dist(r, i));
+  }
+}
+
+template <typename Seq>
+std::pair<double, double> mean_and_variance(const Seq& s) {
+  size_t n = s.size();
+  double mean = parlay::reduce(parlay::map(s, [](auto x) { return static_cast<double>(x); })) / n;
+  double var = parlay::reduce(parlay::map(s, [&](auto x) {
+    return (static_cast<double>(x) - mean) * (static_cast<double>(x) - mean); })) / n;
+  return {mean, var};
+}
+
+TEST(TestRandom, TestUniformReal) {
+  parlay::random r(1);
+  auto dist = parlay::uniform_real_distribution<double>(-1, 3);
+  auto s = parlay::random_sequence(1000000, dist, r);
+  check_samples(s, dist, r);
+  ASSERT_TRUE(parlay::all_of(s, [](double x) { return -1 <= x && x < 3; }));
+  auto [mean, var] = mean_and_variance(s);
+  ASSERT_NEAR(mean, 1.0, 0.01);
+  ASSERT_NEAR(var, 16.0 / 12, 0.01);
+  auto f = parlay::random_sequence(100000, parlay::uniform_real_distribution<float>(), r);
+  ASSERT_TRUE(parlay::all_of(f, [](float x) { return 0 <= x && x < 1; }));
+}
+
+TEST(TestRandom, TestNormal) {
+  parlay::random r(2);
+  auto dist = parlay::normal_distribution<double>(5, 2);
+  auto s = parlay::random_sequence(1000000, dist, r);
+  check_samples(s, dist, r);
+  auto [mean, var] = mean_and_variance(s);
+  ASSERT_NEAR(mean, 5.0, 0.01);
+  ASSERT_NEAR(var, 4.0, 0.03);
+  auto within_one = parlay::count_if(s, [](double x) { return 3 <= x && x <= 7; });
+  ASSERT_NEAR(static_cast<double>(within_one) / s.size(), 0.6827, 0.002);
+}
+
+TEST(TestRandom, TestExponential) {
+  parlay::random r(3);
+  auto dist = parlay::exponential_distribution<double>(4);
+  auto s = parlay::random_sequence(1000000, dist, r);
+  check_samples(s, dist, r);
+  ASSERT_TRUE(parlay::all_of(s, [](double x) { return x >= 0; }));
+  auto [mean, var] = mean_and_variance(s);
+  ASSERT_NEAR(mean, 0.25, 0.002);
+  ASSERT_NEAR(var, 0.0625, 0.002);
+}
+
+TEST(TestRandom, TestGeometric) {
+  parlay::random r(4);
+  auto dist = parlay::geometric_distribution<int>(0.2);
+  auto s = parlay::random_sequence(1000000, dist, r);
+  check_samples(s, dist, r);
+  auto [mean, var] = mean_and_variance(s);
+  ASSERT_NEAR(mean, 4.0, 0.03);
+  ASSERT_NEAR(var, 20.0, 0.3);
+  auto zeros = parlay::count(s, 0);
+  ASSERT_NEAR(static_cast<double>(zeros) / s.size(), 0.2, 0.002);
+  auto ones = parlay::random_sequence(1000, parlay::geometric_distribution<int>(1), r);
+  ASSERT_EQ(parlay::count(ones, 0), 1000u);
+}
+
+TEST(TestRandom, TestZipf) {
+  parlay::random r(5);
+  for (double exponent : {0.5, 1.0, 1.5}) {
+    size_t n = 1000;
+    auto dist = parlay::zipf_distribution<size_t>(n, exponent);
+    auto s = parlay::random_sequence(2000000, dist, r);
+    check_samples(s, dist, r);
+    ASSERT_TRUE(parlay::all_of(s, [&](size_t k) { return 1 <= k && k <= n; }));
+    double total = 0;
+    for (size_t k = 1; k <= n; k++) total += std::pow(k, -exponent);
+    for (size_t k : {1, 2, 3, 10}) {
+      double expected = std::pow(k, -exponent) / total;
+      ASSERT_NEAR(static_cast<double>(parlay::count(s, k)) / s.size(), expected, 0.05 * expected);
+    }
+  }
+}
+
+TEST(TestRandom, TestRandomSample) {
+  size_t n = 1000;
+  auto id = parlay::tabulate(n, [](size_t i) { return i; });
+  for (size_t k : {size_t{0}, size_t{1}, size_t{10}, size_t{500}, size_t{501}, size_t{999}, size_t{1000}}) {
+    auto s = parlay::random_sample(id, k, parlay::random(k));
+    ASSERT_EQ(s.size(), k);
+    ASSERT_TRUE(std::is_sorted(s.begin(), s.end()));
+    ASSERT_EQ(std::adjacent_find(s.begin(), s.end()), s.end());
+    ASSERT_TRUE(parlay::all_of(s, [&](size_t x) { return x < n; }));
+    ASSERT_EQ(s, parlay::random_sample(id, k, parlay::random(k)));
+  }
+  // Each element is chosen with probability k / n
+  size_t trials = 20000;
+  auto counts = parlay::sequence<size_t>(10, 0);
+  for (size_t t = 0; t < trials; t++) {
+    for (size_t x : parlay::random_sample(parlay::iota<size_t>(10), 3, parlay::random(t))) counts[x]++;
+  }
+  for (size_t x = 0; x < 10; x++) {
+    ASSERT_NEAR(static_cast<double>(counts[x]) / trials, 0.3, 0.02);
+  }
+  auto big = parlay::random_sample(parlay::iota<size_t>(100000000), 1000);
+  ASSERT_EQ(big.size(), 1000u);
+  ASSERT_TRUE(std::is_sorted(big.begin(), big.end()));
+  ASSERT_EQ(std::adjacent_find(big.begin(), big.end()), big.end());
+}
+
+TEST(TestRandom, TestDiscrete) {
+  parlay::random r(6);
+  std::vector<double> weights = {1, 2, 3, 4, 0, 10};
+  auto dist = parlay::discrete_distribution<int>(weights);
+  ASSERT_EQ(dist.size(), weights.size());
+  auto s = parlay::random_sequence(1000000, dist, r);
+  check_samples(s, dist, r);
+  ASSERT_EQ(parlay::count(s, 4), 0u);
+  for (int i = 0; i < 6; i++) {
+    ASSERT_NEAR(static_cast<double>(parlay::count(s, i)) / s.size(), weights[i] / 20, 0.002);
+  }
+  // Many random weights, and a few much heavier ones
+  size_t n = 5000;
+  auto w = parlay::tabulate(n, [&](size_t i) -> size_t { return (i % 1000 == 0) ? 100000 : r.ith_rand(i) % 100; });
+  double total = static_cast<double>(parlay::reduce(w));
+  auto big = parlay::random_sequence(10000000, parlay::discrete_distribution<size_t>(w), r);
+  auto counts = parlay::sequence<size_t>(n, 0);
+  for (size_t x : big) counts[x]++;
+  for (size_t i = 0; i < n; i++) {
+    double expected = w[i] / total;
+    ASSERT_NEAR(static_cast<double>(counts[i]) / big.size(), expected, 6 * std::sqrt(expected / big.size()) + 1e-9);
+  }
+  // Equal weights
+  auto equal = parlay::random_sequence(100000, parlay::discrete_distribution<size_t>(std::vector<double>(7, 0.1)), r);
+  for (size_t i = 0; i < 7; i++) {
+    ASSERT_NEAR(static_cast<double>(parlay::count(equal, i)) / equal.size(), 1.0 / 7, 0.01);
+  }
+}
+
+TEST(TestRandom, TestWeightedRandomSample) {
+  std::vector<char> items = {'a', 'b', 'c'};
+  std::vector<int> weights = {1, 0, 3};
+  auto s = parlay::weighted_random_sample(items, weights, 100000, parlay::random(7));
+  ASSERT_EQ(s.size(), 100000u);
+  ASSERT_EQ(parlay::count(s, 'b'), 0u);
+  ASSERT_NEAR(static_cast<double>(parlay::count(s, 'a')) / s.size(), 0.25, 0.01);
+}
+
+TEST(TestRandom, TestReservoirSampler) {
+  size_t k = 100;
+  parlay::reservoir_sampler<size_t> sampler(k, parlay::random(8));
+  ASSERT_TRUE(sampler.sample().empty());
+  size_t n = 0;
+  for (size_t batch : {size_t{10}, size_t{1000}, size_t{0}, size_t{100000}, size_t{7}}) {
+    sampler.insert(parlay::tabulate(batch, [&](size_t i) { return n + i; }));
+    n += batch;
+    auto s = parlay::sort(sampler.sample());
+    ASSERT_EQ(s.size(), (std::min)(n, k));
+    ASSERT_EQ(std::adjacent_find(s.begin(), s.end()), s.end());
+    ASSERT_TRUE(parlay::all_of(s, [&](size_t x) { return x < n; }));
+  }
+  ASSERT_EQ(sampler.count(), n);
+
+  // The sample does not depend on how the stream is split into batches
+  parlay::reservoir_sampler<size_t> whole(k, parlay::random(8));
+  whole.insert(parlay::iota<size_t>(n));
+  ASSERT_EQ(parlay::sort(whole.sample()), parlay::sort(sampler.sample()));
+
+  // Each element is chosen with probability k / n
+  size_t trials = 20000;
+  auto counts = parlay::sequence<size_t>(20, 0);
+  for (size_t t = 0; t < trials; t++) {
+    parlay::reservoir_sampler<size_t> small(5, parlay::random(t));
+    small.insert(parlay::iota<size_t>(8));
+    small.insert(parlay::tabulate(12, [](size_t i) { return i + 8; }));
+    for (size_t x : small.sample()) counts[x]++;
+  }
+  for (size_t x = 0; x < 20; x++) {
+    ASSERT_NEAR(static_cast<double>(counts[x]) / trials, 0.25, 0.02);
+  }
+}
+
+// Counts the copies made of it
+struct copy_counted {
+  static inline std::atomic<size_t> copies{0};
+  size_t value = 0;
+  copy_counted() = default;
+  explicit copy_counted(size_t v) : value(v) {}
+  copy_counted(const copy_counted& other) : value(other.value) { copies++; }
+  copy_counted(copy_counted&&) noexcept = default;
+  copy_counted& operator=(const copy_counted& other) { value = other.value; copies++; return *this; }
+  copy_counted& operator=(copy_counted&&) noexcept = default;
+};
+
+TEST(TestRandom, TestReservoirSamplerCopiesOnlyEntries) {
+  size_t k = 10;
+  auto batch = parlay::tabulate(1000000, [](size_t i) { return copy_counted(i); });
+  parlay::reservoir_sampler<copy_counted> sampler(k, parlay::random(3));
+  copy_counted::copies = 0;
+  sampler.insert(batch);
+  ASSERT_LE(copy_counted::copies.load(), k);
+  sampler.insert(batch);
+  ASSERT_LE(copy_counted::copies.load(), 2 * k);
+  ASSERT_EQ(sampler.sample().size(), k);
+}
+
+TEST(TestRandom, TestReservoirSamplerMerge) {
+  size_t k = 50;
+  parlay::random r(9);
+  auto samplers = parlay::tabulate(4, [&](size_t i) {
+    parlay::reservoir_sampler<size_t> s(k, r.fork(i));
+    s.insert(parlay::tabulate(10000, [&](size_t j) { return i * 10000 + j; }));
+    return s;
+  });
+  for (size_t i = 1; i < 4; i++) samplers[0].merge(samplers[i]);
+  ASSERT_EQ(samplers[0].count(), 40000u);
+  auto s = parlay::sort(samplers[0].sample());
+  ASSERT_EQ(s.size(), k);
+  ASSERT_EQ(std::adjacent_find(s.begin(), s.end()), s.end());
+  // Every part should be represented
+  for (size_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(parlay::any_of(s, [&](size_t x) { return x / 10000 == i; }));
+  }
+}
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <deque>
 #include <numeric>
+#include <string>
 
 #include <parlay/primitives.h>
 #include <parlay/sequence.h>
@@ -134,3 +135,56 @@ TEST(TestSampleSort, TestSortInplaceNonContiguous) {
   ASSERT_EQ(s, s2);
   ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
 }
+
+TEST(TestSampleSort, TestSortInplaceLarge) {
+  auto s = parlay::tabulate(3000000, [](long long i) -> long long {
+    return (50021 * i + 61) % (1 << 30);
+  });
+  auto s2 = s;
+  parlay::internal::sample_sort_inplace(parlay::make_slice(s), std::less<long long>());
+  std::sort(std::begin(s2), std::end(s2));
+  ASSERT_EQ(s, s2);
+}
+
+TEST(TestSampleSort, TestSortInplaceManyDuplicates) {
+  for (long long keys : {1, 2, 3, 10, 100, 1000}) {
+    auto s = parlay::tabulate(1000000, [&](long long i) -> long long {
+      return (50021 * i + 61) % keys;
+    });
+    auto s2 = s;
+    parlay::internal::sample_sort_inplace(parlay::make_slice(s), std::less<long long>());
+    std::sort(std::begin(s2), std::end(s2));
+    ASSERT_EQ(s, s2);
+  }
+}
+
+TEST(TestSampleSort, TestSortInplaceSorted) {
+  auto s = parlay::tabulate(1000000, [](long long i) -> long long { return i; });
+  auto s2 = parlay::tabulate(1000000, [](long long i) -> long long { return 1000000 - i; });
+  auto s3 = s;
+  parlay::internal::sample_sort_inplace(parlay::make_slice(s), std::less<long long>());
+  parlay::internal::sample_sort_inplace(parlay::make_slice(s2), std::less<long long>());
+  ASSERT_EQ(s, s3);
+  ASSERT_TRUE(std::is_sorted(std::begin(s2), std::end(s2)));
+}
+
+TEST(TestSampleSort, TestSortInplaceStrings) {
+  auto s = parlay::tabulate(500000, [](long long i) -> std::string {
+    return std::to_string((50021 * i + 61) % (1 << 20));
+  });
+  auto s2 = s;
+  parlay::internal::sample_sort_inplace(parlay::make_slice(s), std::less<std::string>());
+  std::sort(std::begin(s2), std::end(s2));
+  ASSERT_EQ(s, s2);
+}
+
+TEST(TestSampleSort, TestSortInplaceNonContiguousLarge) {
+  auto ss = parlay::tabulate(1000000, [](long long i) -> long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto s = std::deque<long long>(ss.begin(), ss.end());
+  auto s2 = s;
+  parlay::internal::sample_sort_inplace(parlay::make_slice(s), std::less<long long>());
+  std::sort(std::begin(s2), std::end(s2));
+  ASSERT_EQ(s, s2);
+}
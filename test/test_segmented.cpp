@@ -0,0 +1,133 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <parlay/monoid.h>
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Segment lengths that mix many short segments with a few very long ones
+parlay::sequence<size_t> make_offsets(size_t m) {
+  auto lengths = parlay::tabulate(m, [](size_t i) -> size_t {
+    auto h = parlay::hash64(i);
+    return (h % 100 == 0) ? 50000 + h % 1000 : h % 20;
+  });
+  auto offsets = parlay::sequence<size_t>(m + 1);
+  offsets[0] = 0;
+  for (size_t i = 0; i < m; i++) offsets[i + 1] = offsets[i] + lengths[i];
+  return offsets;
+}
+
+parlay::sequence<bool> offsets_to_flags(const parlay::sequence<size_t>& offsets) {
+  auto flags = parlay::sequence<bool>(offsets.back(), false);
+  for (size_t k = 0; k + 1 < offsets.size(); k++) {
+    if (offsets[k] < offsets.back()) flags[offsets[k]] = true;
+  }
+  return flags;
+}
+
+TEST(TestSegmented, TestScanOffsets) {
+  auto offsets = make_offsets(10000);
+  size_t n = offsets.back();
+  auto s = parlay::tabulate(n, [](size_t i) -> long { return parlay::hash64(i) % 100; });
+  auto scanz = parlay::segmented_scan(s, offsets);
+  auto iscanz = parlay::segmented_scan_inclusive(s, offsets);
+  ASSERT_EQ(scanz.size(), n);
+  ASSERT_EQ(iscanz.size(), n);
+  for (size_t k = 0; k + 1 < offsets.size(); k++) {
+    long r = 0;
+    for (size_t i = offsets[k]; i < offsets[k + 1]; i++) {
+      ASSERT_EQ(scanz[i], r);
+      r += s[i];
+      ASSERT_EQ(iscanz[i], r);
+    }
+  }
+}
+
+TEST(TestSegmented, TestScanFlags) {
+  auto offsets = make_offsets(10000);
+  auto flags = offsets_to_flags(offsets);
+  size_t n = offsets.back();
+  auto s = parlay::tabulate(n, [](size_t i) -> long { return parlay::hash64(i) % 100; });
+  ASSERT_EQ(parlay::segmented_scan(s, flags), parlay::segmented_scan(s, offsets));
+  ASSERT_EQ(parlay::segmented_scan_inclusive(s, flags), parlay::segmented_scan_inclusive(s, offsets));
+}
+
+TEST(TestSegmented, TestScanMax) {
+  auto flags = parlay::tabulate(100000, [](size_t i) -> bool { return i % 1000 == 0; });
+  auto s = parlay::tabulate(100000, [](size_t i) -> int { return parlay::hash64(i) % 1000; });
+  auto scanz = parlay::segmented_scan_inclusive(s, flags, parlay::maxm<int>());
+  int r = 0;
+  for (size_t i = 0; i < s.size(); i++) {
+    if (flags[i]) r = parlay::maxm<int>().identity;
+    r = (std::max)(r, s[i]);
+    ASSERT_EQ(scanz[i], r);
+  }
+}
+
+TEST(TestSegmented, TestReduceOffsets) {
+  auto offsets = make_offsets(10000);
+  size_t n = offsets.back();
+  auto s = parlay::tabulate(n, [](size_t i) -> long { return parlay::hash64(i) % 100; });
+  auto sums = parlay::segmented_reduce(s, offsets);
+  ASSERT_EQ(sums.size(), 10000);
+  for (size_t k = 0; k < sums.size(); k++) {
+    long r = 0;
+    for (size_t i = offsets[k]; i < offsets[k + 1]; i++) r += s[i];
+    ASSERT_EQ(sums[k], r);
+  }
+}
+
+TEST(TestSegmented, TestReduceFlags) {
+  auto offsets = make_offsets(10000);
+  auto flags = offsets_to_flags(offsets);
+  size_t n = offsets.back();
+  auto s = parlay::tabulate(n, [](size_t i) -> long { return parlay::hash64(i) % 100; });
+  // Flags can not represent empty segments
+  auto nonempty = parlay::pack(parlay::segmented_reduce(s, offsets),
+    parlay::tabulate(10000, [&](size_t k) -> bool { return offsets[k] < offsets[k + 1]; }));
+  ASSERT_EQ(parlay::segmented_reduce(s, flags), nonempty);
+}
+
+TEST(TestSegmented, TestSingleSegment) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> long { return i; });
+  auto flags = parlay::sequence<bool>(s.size(), false);
+  ASSERT_EQ(parlay::segmented_scan(s, flags), parlay::scan(s).first);
+  auto sums = parlay::segmented_reduce(s, flags);
+  ASSERT_EQ(sums.size(), 1);
+  ASSERT_EQ(sums[0], parlay::reduce(s));
+}
+
+TEST(TestSegmented, TestEmptySegments) {
+  auto s = parlay::sequence<int>{1, 2, 3, 4, 5};
+  auto offsets = std::vector<int>{0, 0, 2, 2, 5, 5};
+  auto sums = parlay::segmented_reduce(s, offsets);
+  ASSERT_EQ(sums, (parlay::sequence<int>{0, 3, 0, 12, 0}));
+  auto scanz = parlay::segmented_scan(s, offsets);
+  ASSERT_EQ(scanz, (parlay::sequence<int>{0, 1, 0, 3, 7}));
+}
+
+TEST(TestSegmented, TestEmptyInput) {
+  auto s = parlay::sequence<int>();
+  auto flags = parlay::sequence<bool>();
+  ASSERT_TRUE(parlay::segmented_scan(s, flags).empty());
+  ASSERT_TRUE(parlay::segmented_reduce(s, flags).empty());
+  auto offsets = parlay::sequence<size_t>{0, 0, 0};
+  ASSERT_EQ(parlay::segmented_reduce(s, offsets), (parlay::sequence<int>{0, 0}));
+}
+
+TEST(TestSegmented, TestNonCommutative) {
+  // Concatenation of strings is associative but not commutative
+  auto s = parlay::tabulate(20000, [](size_t i) { return std::string(1, 'a' + i % 26); });
+  auto offsets = parlay::tabulate(21, [](size_t k) -> size_t { return k * 1000; });
+  auto m = parlay::make_monoid([](const std::string& a, const std::string& b) { return a + b; }, std::string());
+  auto joined = parlay::segmented_reduce(s, offsets, m);
+  ASSERT_EQ(joined.size(), 20);
+  for (size_t k = 0; k < 20; k++) {
+    std::string expected;
+    for (size_t i = 1000 * k; i < 1000 * (k + 1); i++) expected += s[i];
+    ASSERT_EQ(joined[k], expected);
+  }
+}
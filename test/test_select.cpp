@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <string>
+
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+#include "sorting_utils.h"
+
+// Checks that s is partitioned around position k, and that s[k] is the
+// element that would be there if s were sorted
+template<typename Seq, typename Compare = std::less<>>
+void check_nth_element(const Seq& s, const Seq& sorted, size_t k, Compare less = {}) {
+  ASSERT_FALSE(less(s[k], sorted[k]) || less(sorted[k], s[k]));
+  for (size_t i = 0; i < k; i++) ASSERT_FALSE(less(s[k], s[i]));
+  for (size_t i = k + 1; i < s.size(); i++) ASSERT_FALSE(less(s[i], s[k]));
+}
+
+TEST(TestSelect, TestNthElement) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto sorted = parlay::sort(s);
+  for (size_t k : {size_t{0}, size_t{1}, size_t{500000}, size_t{999999}, size_t{123456}}) {
+    auto s2 = s;
+    parlay::nth_element(s2, k);
+    check_nth_element(s2, sorted, k);
+  }
+}
+
+TEST(TestSelect, TestNthElementSmall) {
+  for (size_t n : {1, 2, 5, 30, 1000}) {
+    auto s = parlay::tabulate(n, [](size_t i) -> int { return parlay::hash64(i) % 100; });
+    auto sorted = parlay::sort(s);
+    for (size_t k = 0; k < n; k += 1 + n / 7) {
+      auto s2 = s;
+      parlay::nth_element(s2, k);
+      check_nth_element(s2, sorted, k);
+    }
+  }
+}
+
+TEST(TestSelect, TestNthElementDuplicates) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> int { return parlay::hash64(i) % 3; });
+  auto sorted = parlay::sort(s);
+  for (size_t k : {size_t{0}, size_t{333333}, size_t{700000}, size_t{999999}}) {
+    auto s2 = s;
+    parlay::nth_element(s2, k);
+    check_nth_element(s2, sorted, k);
+  }
+  auto same = parlay::sequence<int>(1000000, 7);
+  parlay::nth_element(same, 500000);
+  ASSERT_EQ(same[500000], 7);
+}
+
+TEST(TestSelect, TestNthElementCustomCompare) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto sorted = parlay::sort(s, std::greater<long long>());
+  auto s2 = s;
+  parlay::nth_element(s2, 1000, std::greater<long long>());
+  check_nth_element(s2, sorted, 1000, std::greater<long long>());
+}
+
+TEST(TestSelect, TestNthElementUncopyable) {
+  auto s = parlay::tabulate(100000, [](size_t i) {
+    return UncopyableThing(parlay::hash64(i) % 100000); });
+  auto values = parlay::tabulate(100000, [](size_t i) -> int { return parlay::hash64(i) % 100000; });
+  std::sort(values.begin(), values.end());
+  parlay::nth_element(s, 5000);
+  ASSERT_EQ(s[5000].x, values[5000]);
+  for (size_t i = 0; i < 5000; i++) ASSERT_LE(s[i].x, s[5000].x);
+  for (size_t i = 5001; i < s.size(); i++) ASSERT_GE(s[i].x, s[5000].x);
+}
+
+TEST(TestSelect, TestNthElementNonContiguous) {
+  auto ss = parlay::tabulate(100000, [](size_t i) -> int { return parlay::hash64(i) % 100000; });
+  auto s = std::deque<int>(ss.begin(), ss.end());
+  auto sorted = parlay::sort(ss);
+  parlay::nth_element(s, 40000);
+  ASSERT_EQ(s[40000], sorted[40000]);
+}
+
+TEST(TestSelect, TestPartialSort) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto sorted = parlay::sort(s);
+  for (size_t k : {size_t{0}, size_t{1}, size_t{100}, size_t{100000}, size_t{1000000}}) {
+    auto s2 = s;
+    parlay::partial_sort(s2, k);
+    ASSERT_TRUE(std::equal(s2.begin(), s2.begin() + k, sorted.begin()));
+    auto rest = parlay::sort(s2);
+    ASSERT_EQ(rest, sorted);
+  }
+}
+
+TEST(TestSelect, TestTopK) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> long long {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  auto sorted = parlay::sort(s, std::greater<long long>());
+  for (size_t k : {size_t{0}, size_t{1}, size_t{100}, size_t{300000}, size_t{1000000}, size_t{2000000}}) {
+    auto top = parlay::top_k(s, k);
+    ASSERT_EQ(top.size(), (std::min)(k, s.size()));
+    ASSERT_TRUE(std::equal(top.begin(), top.end(), sorted.begin()));
+  }
+}
+
+TEST(TestSelect, TestTopKCustomCompare) {
+  auto s = parlay::tabulate(100000, [](size_t i) { return std::to_string(parlay::hash64(i) % 1000000); });
+  auto sorted = parlay::sort(s);
+  auto top = parlay::top_k(s, 50, std::less<std::string>());
+  ASSERT_EQ(top, parlay::to_sequence(sorted.cut(0, 50)));
+}
+
+TEST(TestSelect, TestTopKDuplicates) {
+  auto s = parlay::tabulate(1000000, [](size_t i) -> int { return parlay::hash64(i) % 10; });
+  auto top = parlay::top_k(s, 1000);
+  ASSERT_EQ(top, parlay::sequence<int>(1000, 9));
+}
@@ -816,5 +816,28 @@ TEST(TestSequence, TestGetAllocator) {
   ASSERT_EQ(alloc, std::allocator<int>());
 }
 
+TEST(TestSequence, TestAlignedAllocator) {
+  parlay::sequence<float, parlay::aligned_allocator<float>> s;
+  for (int i = 0; i < 100000; i++) {
+    s.push_back(i);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(s.data()) % 64, 0);
+  }
+  for (int i = 0; i < 100000; i++) {
+    ASSERT_EQ(s[i], i);
+  }
+}
+
+TEST(TestSequence, TestAlignedAllocatorLarge) {
+  for (size_t n : {size_t{1}, size_t{3}, size_t{17}, size_t{1000}, size_t{1000000}}) {
+    auto s = parlay::sequence<char, parlay::aligned_allocator<char>>(n, 'x');
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(s.data()) % 64, 0);
+    auto s2 = parlay::sequence<double, parlay::aligned_allocator<double, 256>>(n, 1.0);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(s2.data()) % 256, 0);
+    auto s3 = s2;
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(s3.data()) % 256, 0);
+    ASSERT_EQ(s2, s3);
+  }
+}
+
 // TODO: More thorough tests with custom allocators
 // to validate allocator usage.
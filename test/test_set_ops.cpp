@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+template<typename T, typename Compare = std::less<T>>
+parlay::sequence<T> sorted_random(size_t n, size_t range, size_t seed, Compare comp = {}) {
+  auto s = parlay::tabulate(n, [&](size_t i) -> T { return parlay::hash64(i + seed * n) % range; });
+  return parlay::sort(s, comp);
+}
+
+// Checks all four operations against the std:: algorithms
+template<typename T, typename Compare = std::less<T>>
+void check_set_ops(const parlay::sequence<T>& a, const parlay::sequence<T>& b, Compare comp = {}) {
+  std::vector<T> expected;
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected), comp);
+  ASSERT_EQ(parlay::set_union(a, b, comp), parlay::to_sequence(expected));
+  expected.clear();
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected), comp);
+  ASSERT_EQ(parlay::set_intersection(a, b, comp), parlay::to_sequence(expected));
+  expected.clear();
+  std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected), comp);
+  ASSERT_EQ(parlay::set_difference(a, b, comp), parlay::to_sequence(expected));
+  expected.clear();
+  std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected), comp);
+  ASSERT_EQ(parlay::set_symmetric_difference(a, b, comp), parlay::to_sequence(expected));
+}
+
+TEST(TestSetOps, TestSameSize) {
+  auto a = sorted_random<long>(100000, 200000, 1);
+  auto b = sorted_random<long>(100000, 200000, 2);
+  check_set_ops(a, b);
+}
+
+TEST(TestSetOps, TestDuplicates) {
+  auto a = sorted_random<int>(100000, 100, 1);
+  auto b = sorted_random<int>(50000, 150, 2);
+  check_set_ops(a, b);
+  check_set_ops(b, a);
+}
+
+TEST(TestSetOps, TestSkewed) {
+  auto a = sorted_random<long>(1000000, 10000000, 1);
+  auto b = sorted_random<long>(100, 10000000, 2);
+  check_set_ops(a, b);
+  check_set_ops(b, a);
+}
+
+TEST(TestSetOps, TestDisjointRanges) {
+  auto a = parlay::tabulate(100000, [](size_t i) -> long { return i; });
+  auto b = parlay::tabulate(100000, [](size_t i) -> long { return 100000 + i; });
+  check_set_ops(a, b);
+  check_set_ops(b, a);
+}
+
+TEST(TestSetOps, TestEmpty) {
+  auto a = sorted_random<int>(10000, 100000, 1);
+  auto e = parlay::sequence<int>();
+  check_set_ops(a, e);
+  check_set_ops(e, a);
+  check_set_ops(e, e);
+}
+
+TEST(TestSetOps, TestDefaultCompare) {
+  auto a = parlay::sequence<int>{1, 2, 2, 3, 5, 8};
+  auto b = parlay::sequence<int>{2, 3, 3, 4, 8};
+  ASSERT_EQ(parlay::set_union(a, b), (parlay::sequence<int>{1, 2, 2, 3, 3, 4, 5, 8}));
+  ASSERT_EQ(parlay::set_intersection(a, b), (parlay::sequence<int>{2, 3, 8}));
+  ASSERT_EQ(parlay::set_difference(a, b), (parlay::sequence<int>{1, 2, 5}));
+  ASSERT_EQ(parlay::set_symmetric_difference(a, b), (parlay::sequence<int>{1, 2, 3, 4, 5}));
+}
+
+TEST(TestSetOps, TestCustomCompare) {
+  auto a = sorted_random<long>(100000, 300000, 1, std::greater<long>());
+  auto b = sorted_random<long>(20000, 300000, 2, std::greater<long>());
+  check_set_ops(a, b, std::greater<long>());
+}
+
+TEST(TestSetOps, TestStrings) {
+  auto a = parlay::sort(parlay::tabulate(50000, [](size_t i) { return std::to_string(parlay::hash64(i) % 100000); }));
+  auto b = parlay::sort(parlay::tabulate(30000, [](size_t i) { return std::to_string(parlay::hash64(i + 7) % 100000); }));
+  check_set_ops(a, b);
+}
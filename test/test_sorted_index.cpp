@@ -0,0 +1,98 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+#include <parlay/sorted_index.h>
+
+// Checks the index against std::lower_bound for every query
+template<typename T, typename Compare = std::less<T>>
+void check_sorted_index(const parlay::sequence<T>& keys, const parlay::sequence<T>& queries,
+                        Compare less = {}) {
+  auto index = parlay::sorted_index<T, Compare>(keys, less);
+  ASSERT_EQ(index.size(), keys.size());
+  auto expected = parlay::map(queries, [&](const T& x) -> size_t {
+    return std::lower_bound(keys.begin(), keys.end(), x, less) - keys.begin(); });
+  ASSERT_EQ(index.lower_bound(queries), expected);
+  for (size_t i = 0; i < queries.size(); i++) {
+    ASSERT_EQ(index.lower_bound(queries[i]), expected[i]);
+  }
+}
+
+TEST(TestSortedIndex, TestEmpty) {
+  parlay::sequence<int> keys;
+  auto index = parlay::sorted_index<int>(keys);
+  ASSERT_TRUE(index.empty());
+  ASSERT_EQ(index.lower_bound(5), 0);
+  auto r = index.lower_bound(parlay::sequence<int>{1, 2, 3});
+  ASSERT_EQ(r, parlay::sequence<size_t>(3, 0));
+}
+
+TEST(TestSortedIndex, TestDefaultConstruct) {
+  parlay::sorted_index<long> index;
+  ASSERT_TRUE(index.empty());
+  ASSERT_EQ(index.lower_bound(5L), 0);
+}
+
+TEST(TestSortedIndex, TestConvertibleQuery) {
+  auto keys = parlay::tabulate(100, [](size_t i) -> long { return 2 * i; });
+  auto index = parlay::sorted_index<long>(keys);
+  size_t r = index.lower_bound(41);
+  ASSERT_EQ(r, 21);
+  auto rs = index.lower_bound(parlay::sequence<long>{41, 0, 500});
+  ASSERT_EQ(rs, (parlay::sequence<size_t>{21, 0, 100}));
+}
+
+TEST(TestSortedIndex, TestAllSmallSizes) {
+  // Every shape of the last level of the tree, with queries
+  // that hit every key and every gap between keys
+  for (size_t n = 1; n <= 300; n++) {
+    auto keys = parlay::tabulate(n, [](size_t i) -> int { return 2 * i + 1; });
+    auto queries = parlay::tabulate(2 * n + 40, [](size_t i) -> int { return static_cast<int>(i) - 3; });
+    check_sorted_index(keys, queries);
+  }
+}
+
+TEST(TestSortedIndex, TestLarge) {
+  size_t n = 1000000;
+  auto keys = parlay::sort(parlay::tabulate(n, [&](size_t i) -> long { return parlay::hash64(i) % (4 * n); }));
+  auto queries = parlay::tabulate(n, [&](size_t i) -> long { return parlay::hash64(n + i) % (4 * n + 10); });
+  check_sorted_index(keys, queries);
+}
+
+TEST(TestSortedIndex, TestDuplicates) {
+  size_t n = 100000;
+  auto keys = parlay::sort(parlay::tabulate(n, [](size_t i) -> unsigned int { return parlay::hash64(i) % 100; }));
+  auto queries = parlay::tabulate(1000, [](size_t i) -> unsigned int { return i % 110; });
+  check_sorted_index(keys, queries);
+}
+
+TEST(TestSortedIndex, TestSmallKeys) {
+  auto keys = parlay::sort(parlay::tabulate(50000, [](size_t i) -> unsigned char { return parlay::hash64(i) % 200; }));
+  auto queries = parlay::tabulate(256, [](size_t i) -> unsigned char { return i; });
+  check_sorted_index(keys, queries);
+}
+
+TEST(TestSortedIndex, TestDoubles) {
+  size_t n = 100000;
+  auto keys = parlay::tabulate(n, [](size_t i) -> double { return 0.5 * i; });
+  auto queries = parlay::tabulate(3 * n, [](size_t i) -> double { return 0.2 * i - 10; });
+  check_sorted_index(keys, queries);
+}
+
+TEST(TestSortedIndex, TestCustomCompare) {
+  size_t n = 100000;
+  auto keys = parlay::tabulate(n, [&](size_t i) -> long { return n - i; });
+  auto queries = parlay::tabulate(n + 10, [](size_t i) -> long { return i; });
+  check_sorted_index(keys, queries, std::greater<long>());
+}
+
+TEST(TestSortedIndex, TestStrings) {
+  size_t n = 20000;
+  auto keys = parlay::sort(parlay::tabulate(n, [](size_t i) { return std::to_string(parlay::hash64(i) % 100000); }));
+  auto queries = parlay::tabulate(5000, [](size_t i) { return std::to_string(i * 17); });
+  check_sorted_index(keys, queries);
+}
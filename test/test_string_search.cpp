@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+
+#include <cctype>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <parlay/primitives.h>
+#include <parlay/sequence.h>
+
+// Generate a text over a small alphabet so that patterns occur often
+parlay::sequence<char> random_text(size_t n, size_t alphabet, size_t seed = 0) {
+  return parlay::tabulate(n, [&](size_t i) -> char {
+    return static_cast<char>('a' + parlay::hash64(i + seed) % alphabet); });
+}
+
+template<typename Text, typename Pattern>
+parlay::sequence<size_t> naive_find_all(const Text& text, const Pattern& pattern) {
+  parlay::sequence<size_t> result;
+  size_t n = text.size(), m = pattern.size();
+  if (m == 0) return result;
+  for (size_t i = 0; i + m <= n; i++) {
+    size_t j = 0;
+    while (j < m && text[i + j] == pattern[j]) j++;
+    if (j == m) result.push_back(i);
+  }
+  return result;
+}
+
+template<typename Text, typename Patterns>
+parlay::sequence<std::pair<size_t, size_t>> naive_find_all_patterns(const Text& text, const Patterns& patterns) {
+  parlay::sequence<std::pair<size_t, size_t>> result;
+  for (size_t i = 0; i < text.size(); i++) {
+    for (size_t p = 0; p < patterns.size(); p++) {
+      const auto& P = patterns[p];
+      size_t j = 0;
+      while (j < P.size() && i + j < text.size() && text[i + j] == P[j]) j++;
+      if (!P.empty() && j == P.size()) result.push_back(std::make_pair(i, p));
+    }
+  }
+  return result;
+}
+
+TEST(TestStringSearch, TestFindAllOverlapping) {
+  auto text = parlay::to_sequence(std::string("aaaabaaa"));
+  auto pattern = parlay::to_sequence(std::string("aa"));
+  ASSERT_EQ(parlay::find_all(text, pattern), (parlay::sequence<size_t>{0, 1, 2, 5, 6}));
+}
+
+TEST(TestStringSearch, TestFindAllEmpty) {
+  auto text = random_text(1000, 3);
+  ASSERT_TRUE(parlay::find_all(text, parlay::sequence<char>()).empty());
+  ASSERT_TRUE(parlay::find_all(parlay::sequence<char>(), text).empty());
+  ASSERT_TRUE(parlay::find_all(text.cut(0, 10), text.cut(0, 11)).empty());
+}
+
+TEST(TestStringSearch, TestFindAllLengths) {
+  // Covers patterns of length 1 and 2, which skip the middle comparison,
+  // and texts that span many chunks and end in the middle of a vector
+  auto text = random_text(300007, 3);
+  for (size_t m = 1; m <= 12; m++) {
+    auto pattern = random_text(m, 3, 1000 * m);
+    auto expected = naive_find_all(text, pattern);
+    ASSERT_EQ(parlay::find_all(text, pattern), expected);
+  }
+}
+
+TEST(TestStringSearch, TestFindAllAcrossChunks) {
+  // A pattern that occurs exactly once, at every possible offset around a chunk boundary
+  size_t n = (1 << 16) + 100;
+  for (size_t pos = (1 << 16) - 20; pos < (1 << 16) + 5; pos++) {
+    parlay::sequence<char> text(n, 'x');
+    auto pattern = parlay::to_sequence(std::string("needle_in_haystack"));
+    std::copy(pattern.begin(), pattern.end(), text.begin() + pos);
+    ASSERT_EQ(parlay::find_all(text, pattern), parlay::sequence<size_t>{pos});
+  }
+}
+
+TEST(TestStringSearch, TestFindAllString) {
+  std::string text(200000, 'b');
+  for (size_t i = 0; i < text.size(); i += 1001) text[i] = 'a';
+  std::string pattern = "abbb";
+  ASSERT_EQ(parlay::find_all(text, pattern), naive_find_all(text, pattern));
+}
+
+TEST(TestStringSearch, TestFindAllIntegers) {
+  auto text = parlay::tabulate(200000, [](size_t i) -> int { return parlay::hash64(i) % 4; });
+  auto pattern = parlay::sequence<int>{1, 2, 3, 0, 1};
+  ASSERT_EQ(parlay::find_all(text, pattern), naive_find_all(text, pattern));
+}
+
+TEST(TestStringSearch, TestFindAllPredicate) {
+  auto text = parlay::to_sequence(std::string("Parlay parlay PARLAY parley"));
+  auto pattern = parlay::to_sequence(std::string("parlay"));
+  auto case_insensitive = [](char a, char b) { return std::tolower(a) == std::tolower(b); };
+  ASSERT_EQ(parlay::find_all(text, pattern, case_insensitive), (parlay::sequence<size_t>{0, 7, 14}));
+}
+
+TEST(TestStringSearch, TestFindAllPatterns) {
+  auto text = random_text(300000, 2);
+  std::vector<std::string> patterns = {"abba", "a", "bbbbbbbbbbbb", "ab", "abba", "", "babababab", "aaaaaaaaaaaaaaaaaaaaaa"};
+  auto expected = naive_find_all_patterns(text, patterns);
+  ASSERT_EQ(parlay::find_all_patterns(text, patterns), expected);
+}
+
+TEST(TestStringSearch, TestFindAllPatternsManyPatterns) {
+  auto text = random_text(200000, 4);
+  auto patterns = parlay::tabulate(200, [](size_t i) {
+    return random_text(3 + i % 7, 4, 7919 * i); });
+  auto expected = naive_find_all_patterns(text, patterns);
+  ASSERT_EQ(parlay::find_all_patterns(text, patterns), expected);
+}
+
+TEST(TestStringSearch, TestFindAllPatternsEdgeCases) {
+  auto text = parlay::to_sequence(std::string("abc"));
+  std::vector<std::string> none;
+  ASSERT_TRUE(parlay::find_all_patterns(text, none).empty());
+  std::vector<std::string> longer = {"abcd", "bc"};
+  auto expected = parlay::sequence<std::pair<size_t, size_t>>{{1, 1}};
+  ASSERT_EQ(parlay::find_all_patterns(text, longer), expected);
+  ASSERT_TRUE(parlay::find_all_patterns(parlay::sequence<char>(), longer).empty());
+}
@@ -103,3 +103,11 @@ TEST(TestUninitializedMemory, TestIntegerSortInPlace) {
   parlay::internal::integer_sort_inplace(make_slice(s), [](auto s) { return s.x; });
   ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
 }
+
+TEST(TestUninitializedMemory, TestIntegerSortInPlaceLowMemory) {
+  auto s = parlay::tabulate(10000000, [](size_t i) -> parlay::internal::UninitializedTracker {
+    return (50021 * i + 61) % (1 << 20);
+  });
+  parlay::internal::integer_sort_inplace(make_slice(s), [](auto s) { return s.x; }, 0, parlay::fl_low_memory);
+  ASSERT_TRUE(std::is_sorted(std::begin(s), std::end(s)));
+}